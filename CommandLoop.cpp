@@ -0,0 +1,157 @@
+#include "CommandLoop.h"
+#include "SpscRing.h"
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+CommandRunner::CommandRunner(RunwayGroups& s, const LoopOptions& options, OutputSink& out)
+    : scheduler(s), output(out), journal(options.journal),
+      checkpointEvery(options.checkpointEvery) {}
+
+// Stop journaling after an I/O error; scheduling carries on
+void CommandRunner::journalFailed() {
+    std::cerr << "Journal write failed; journaling stopped" << std::endl;
+    journal = nullptr;
+}
+
+// Checkpoint when due, and after a Restore or Commit replaced the state
+// the journal extends. An open what-if branch is never checkpointed.
+void CommandRunner::maybeCheckpoint(const Command& command) {
+    bool due = command.type == CMD_RESTORE || command.type == CMD_COMMIT ||
+               (checkpointEvery > 0 && journal->sinceCheckpoint() >= checkpointEvery);
+    if (due && !scheduler.simulating() && 
+        !journal->checkpoint(scheduler)) {
+        journalFailed();
+    }
+}
+
+// Run one command; returns true when input should stop after it
+bool CommandRunner::run(const Command& command) {
+    if (journal && Journal::journaled(command) && !scheduler.simulating() &&
+        !journal->append(command)) {
+        journalFailed();
+    }
+    
+    scheduler.execute(command, output);
+    
+    if (journal) {
+        maybeCheckpoint(command);
+    }
+    return command.stop;
+}
+
+// Sync the journaled commands
+void CommandRunner::sync() {
+    if (journal && !journal->commit()) {
+        journalFailed();
+    }
+}
+
+// Flush output and sync the journal
+void CommandRunner::finish() {
+    output.flush();
+    sync();
+}
+
+namespace {
+
+// Decoded commands waiting for the scheduler thread
+typedef SpscRing<Command, 4096> CommandRing;
+// Output chunks waiting for the writer thread
+typedef SpscRing<std::string, 64> OutputRing;
+
+// Hands each full output buffer to the writer thread as one record
+class RingSink : public OutputSink {
+private:
+    OutputRing& ring;
+
+protected:
+    void drain(const char* data, size_t length) {
+        std::string record(data, length);
+        ring.push(record);
+    }
+
+public:
+    explicit RingSink(OutputRing& r) : ring(r) {}
+};
+
+// Run commands from reader until a stop command or the end of input
+template<typename Reader>
+void runCommands(Reader& reader, CommandRunner& runner) {
+    Command command;
+    while (reader.next(command)) {
+        if (runner.run(command)) {
+            break;
+        }
+    }
+    runner.finish();
+}
+
+// Push commands from reader into the ring, ending at a stop command
+template<typename Reader>
+void parseCommands(Reader reader, CommandRing& commands) {
+    Command command;
+    while (reader.next(command)) {
+        commands.push(command);
+        if (command.stop) {
+            break;
+        }
+    }
+    commands.close();
+}
+
+} // namespace
+
+// Parse and run commands on the calling thread
+void runSequential(const char* begin, const char* end, RunwayGroups& scheduler,
+                   const LoopOptions& options, OutputSink& output) {
+    CommandRunner runner(scheduler, options, output);
+    if (isBinaryCommands(begin, end)) {
+        BinaryCommandReader reader(begin, end);
+        runCommands(reader, runner);
+    } else {
+        CommandReader reader(begin, end);
+        runCommands(reader, runner);
+    }
+}
+
+// Parser thread -> command ring -> scheduler (this thread) -> output ring
+// -> writer thread
+void runPipelined(const char* begin, const char* end, RunwayGroups& scheduler,
+                  const LoopOptions& options, OutputSink& output) {
+    CommandRing commands;
+    OutputRing records;
+    
+    std::thread parser([&commands, begin, end] {
+        if (isBinaryCommands(begin, end)) {
+            parseCommands(BinaryCommandReader(begin, end), commands);
+        } else {
+            parseCommands(CommandReader(begin, end), commands);
+        }
+    });
+    
+    std::thread writer([&records, &output] {
+        std::string record;
+        while (records.pop(record)) {
+            output << record;
+        }
+        output.flush();
+    });
+    
+    RingSink scheduled(records);
+    CommandRunner runner(scheduler, options, scheduled);
+    Command command;
+    
+    // The parser also ends at a stop command, so nothing is left behind
+    while (commands.pop(command)) {
+        if (runner.run(command)) {
+            break;
+        }
+    }
+    runner.finish();
+    records.close();
+    
+    parser.join();
+    writer.join();
+}
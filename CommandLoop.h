@@ -0,0 +1,54 @@
+#ifndef COMMAND_LOOP_H
+#define COMMAND_LOOP_H
+
+#include "Journal.h"
+#include "RunwayGroups.h"
+
+// How the command loops feed the scheduler
+struct LoopOptions {
+    // Journal state-changing commands before running them, when set
+    Journal* journal;
+    // Checkpoint after this many journaled commands (0: never)
+    size_t checkpointEvery;
+    
+    LoopOptions() : journal(nullptr), checkpointEvery(0) {}
+};
+
+// Feeds decoded commands to the scheduler, journaling state changes. The
+// command loops and SchedulerServer all run commands through one.
+class CommandRunner {
+private:
+    RunwayGroups& scheduler;
+    OutputSink& output;
+    Journal* journal;
+    size_t checkpointEvery;
+    
+    // Stop journaling after an I/O error; scheduling carries on
+    void journalFailed();
+    // Checkpoint when due, and after a Restore or Commit
+    void maybeCheckpoint(const Command& command);
+
+public:
+    CommandRunner(RunwayGroups& s, const LoopOptions& options, OutputSink& out);
+    
+    // Run one command; returns true when input should stop after it
+    bool run(const Command& command);
+    // Sync the journaled commands
+    void sync();
+    // Flush output and sync the journal
+    void finish();
+};
+
+// The input buffer holds text commands or, if it starts with a binary
+// header, CommandRecords (BinaryCommandReader).
+
+// Parse and run commands on the calling thread
+void runSequential(const char* begin, const char* end, RunwayGroups& scheduler,
+                   const LoopOptions& options, OutputSink& output);
+
+// Parse on one thread, run commands on the calling thread and write output
+// on a third, linked by single-producer rings. Output matches runSequential.
+void runPipelined(const char* begin, const char* end, RunwayGroups& scheduler,
+                  const LoopOptions& options, OutputSink& output);
+
+#endif // COMMAND_LOOP_H
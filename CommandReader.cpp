@@ -0,0 +1,244 @@
+#include "CommandReader.h"
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Match a command name by length and first character, then confirm
+static CommandType commandType(const char* name, size_t length) {
+    const char* expected = nullptr;
+    CommandType type = CMD_UNKNOWN;
+    
+    switch (length) {
+    case 4:
+        if (name[0] == 'T') { expected = "Tick"; type = CMD_TICK; }
+        else if (name[0] == 'Q') { expected = "Quit"; type = CMD_QUIT; }
+        break;
+    case 5:
+        expected = "Stats"; type = CMD_STATS;
+        break;
+    case 6:
+        expected = "Commit"; type = CMD_COMMIT;
+        break;
+    case 7:
+        if (name[0] == 'R') { expected = "Restore"; type = CMD_RESTORE; }
+        else if (name[0] == 'D') { expected = "Discard"; type = CMD_DISCARD; }
+        break;
+    case 8:
+        if (name[0] == 'S' && name[1] == 'n') { expected = "Snapshot"; type = CMD_SNAPSHOT; }
+        else if (name[0] == 'S') { expected = "Simulate"; type = CMD_SIMULATE; }
+        break;
+    case 10:
+        if (name[0] == 'I') { expected = "Initialize"; type = CMD_INITIALIZE; }
+        else if (name[0] == 'A') { expected = "AddRunways"; type = CMD_ADD_RUNWAYS; }
+        else if (name[0] == 'G') { expected = "GroundHold"; type = CMD_GROUND_HOLD; }
+        break;
+    case 11:
+        expected = "PrintActive"; type = CMD_PRINT_ACTIVE;
+        break;
+    case 12:
+        if (name[0] == 'S') { expected = "SubmitFlight"; type = CMD_SUBMIT_FLIGHT; }
+        else if (name[0] == 'C') { expected = "CancelFlight"; type = CMD_CANCEL_FLIGHT; }
+        else if (name[0] == 'R') { expected = "Reprioritize"; type = CMD_REPRIORITIZE; }
+        break;
+    case 13:
+        if (name[0] == 'P') { expected = "PrintSchedule"; type = CMD_PRINT_SCHEDULE; }
+        else if (name[0] == 'D') { expected = "DelayEstimate"; type = CMD_DELAY_ESTIMATE; }
+        break;
+    }
+    
+    if (expected && std::memcmp(name, expected, length) == 0) {
+        return type;
+    }
+    return CMD_UNKNOWN;
+}
+
+// Input spelling of a command type
+const char* commandName(CommandType type) {
+    static const char* const names[] = {
+        "Unknown", "Initialize", "SubmitFlight", "CancelFlight", "Reprioritize",
+        "AddRunways", "GroundHold", "PrintActive", "PrintSchedule", "Tick", "Quit", "Stats",
+        "Snapshot", "Restore", "Simulate", "Commit", "Discard", "DelayEstimate"
+    };
+    return names[type];
+}
+
+// Parse a leading integer with an optional sign; like std::stoi, trailing
+// characters are ignored
+static bool parseInt(const char* p, const char* end, int& value) {
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        p++;
+    }
+    if (p == end || *p < '0' || *p > '9') return false;
+    
+    unsigned magnitude = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        magnitude = magnitude * 10 + (unsigned)(*p - '0');
+        p++;
+    }
+    value = negative ? (int)(0u - magnitude) : (int)magnitude;
+    return true;
+}
+
+// Check whether the slice contains "Quit"
+static bool mentionsQuit(const char* begin, const char* end) {
+    for (const char* p = begin; p + 4 <= end; p++) {
+        if (p[0] == 'Q' && std::memcmp(p, "Quit", 4) == 0) return true;
+    }
+    return false;
+}
+
+// Decode "Name(a, b, ...)"; arguments end at the first ')' on the line
+bool parseCommandLine(const char* begin, const char* end, Command& command) {
+    command.type = CMD_UNKNOWN;
+    command.argCount = 0;
+    command.text = nullptr;
+    command.textLength = 0;
+    
+    const char* open = static_cast<const char*>(std::memchr(begin, '(', end - begin));
+    if (!open) return false;
+    
+    const char* close = static_cast<const char*>(std::memchr(begin, ')', end - begin));
+    if (!close || close < open) close = end;
+    
+    // Snapshot and Restore take a path, kept as trimmed text
+    CommandType type = commandType(begin, open - begin);
+    if (type == CMD_SNAPSHOT || type == CMD_RESTORE) {
+        const char* first = open + 1;
+        const char* last = close;
+        while (first < last && (*first == ' ' || *first == '\t')) first++;
+        while (last > first && (last[-1] == ' ' || last[-1] == '\t')) last--;
+        if (first == last) return false;
+        
+        command.type = type;
+        command.text = first;
+        command.textLength = (int)(last - first);
+        return true;
+    }
+    
+    // Split on ',' and trim spaces and tabs; empty tokens are skipped
+    const char* p = open + 1;
+    while (p <= close) {
+        const char* comma = static_cast<const char*>(std::memchr(p, ',', close - p));
+        const char* tokenEnd = comma ? comma : close;
+        
+        const char* first = p;
+        const char* last = tokenEnd;
+        while (first < last && (*first == ' ' || *first == '\t')) first++;
+        while (last > first && (last[-1] == ' ' || last[-1] == '\t')) last--;
+        
+        if (first < last) {
+            int value;
+            if (!parseInt(first, last, value)) return false;
+            if (command.argCount < Command::MAX_ARGS) {
+                command.args[command.argCount] = value;
+            }
+            command.argCount++;
+        }
+        p = tokenEnd + 1;
+    }
+    
+    command.type = type;
+    return true;
+}
+
+// Copy type, argument count and arguments into a record
+bool encodeCommand(const Command& command, CommandRecord& record) {
+    if (command.type == CMD_SNAPSHOT || command.type == CMD_RESTORE) return false;
+    
+    std::memset(&record, 0, sizeof(record));
+    record.type = (uint8_t)command.type;
+    record.argCount = (uint8_t)(command.argCount < 255 ? command.argCount : 255);
+    record.flags = command.stop ? CommandRecord::STOP : 0;
+    for (int i = 0; i < command.argCount && i < Command::MAX_ARGS; i++) {
+        record.args[i] = command.args[i];
+    }
+    return true;
+}
+
+// Rebuild a command from a record
+void decodeCommand(const CommandRecord& record, Command& command) {
+    command.type = record.type < COMMAND_TYPES && record.type != CMD_SNAPSHOT && 
+                   record.type != CMD_RESTORE ? (CommandType)record.type : CMD_UNKNOWN;
+    command.argCount = record.argCount;
+    for (int i = 0; i < Command::MAX_ARGS; i++) {
+        command.args[i] = record.args[i];
+    }
+    command.text = nullptr;
+    command.textLength = 0;
+    command.stop = (record.flags & CommandRecord::STOP) != 0;
+}
+
+// Header words of a binary input file
+void binaryCommandsHeader(uint32_t header[4]) {
+    header[0] = BINARY_COMMANDS_MAGIC;
+    header[1] = BINARY_COMMANDS_VERSION;
+    header[2] = sizeof(CommandRecord);
+    header[3] = 0;
+}
+
+// Magic, version and record size must all match
+bool isBinaryCommands(const char* begin, const char* end) {
+    if ((size_t)(end - begin) < BINARY_COMMANDS_HEADER) return false;
+    
+    uint32_t expected[4];
+    binaryCommandsHeader(expected);
+    return std::memcmp(begin, expected, 3 * sizeof(uint32_t)) == 0;
+}
+
+MappedFile::~MappedFile() {
+    if (length > 0) {
+        munmap(const_cast<char*>(data), length);
+    }
+}
+
+// Map the whole file read-only; empty files map to an empty range
+bool MappedFile::open(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return false;
+    }
+    
+    if (info.st_size > 0) {
+        void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            close(fd);
+            return false;
+        }
+        madvise(mapped, info.st_size, MADV_SEQUENTIAL);
+        data = static_cast<const char*>(mapped);
+        length = info.st_size;
+    }
+    
+    close(fd);
+    return true;
+}
+
+// Decode the next non-empty line, trimming " \t\r" like the old getline path
+bool CommandReader::next(Command& command) {
+    while (pos < limit) {
+        const char* newline = static_cast<const char*>(std::memchr(pos, '\n', limit - pos));
+        const char* lineEnd = newline ? newline : limit;
+        const char* first = pos;
+        const char* last = lineEnd;
+        pos = newline ? newline + 1 : limit;
+        
+        while (first < last && (*first == ' ' || *first == '\t' || *first == '\r')) first++;
+        while (last > first && (last[-1] == ' ' || last[-1] == '\t' || last[-1] == '\r')) last--;
+        if (first == last) continue;
+        
+        if (!parseCommandLine(first, last, command)) {
+            command.type = CMD_UNKNOWN;
+        }
+        command.stop = mentionsQuit(first, last);
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,146 @@
+#ifndef COMMAND_READER_H
+#define COMMAND_READER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+// Operations accepted in the input file
+enum CommandType {
+    CMD_UNKNOWN,
+    CMD_INITIALIZE,
+    CMD_SUBMIT_FLIGHT,
+    CMD_CANCEL_FLIGHT,
+    CMD_REPRIORITIZE,
+    CMD_ADD_RUNWAYS,
+    CMD_GROUND_HOLD,
+    CMD_PRINT_ACTIVE,
+    CMD_PRINT_SCHEDULE,
+    CMD_TICK,
+    CMD_QUIT,
+    CMD_STATS,
+    CMD_SNAPSHOT,
+    CMD_RESTORE,
+    CMD_SIMULATE,
+    CMD_COMMIT,
+    CMD_DISCARD,
+    CMD_DELAY_ESTIMATE
+};
+
+// Number of command types, for tables indexed by CommandType
+const int COMMAND_TYPES = CMD_DELAY_ESTIMATE + 1;
+
+// Input spelling of a command type
+const char* commandName(CommandType type);
+
+// One decoded input line
+struct Command {
+    enum { MAX_ARGS = 6 };
+    
+    CommandType type;
+    // Arguments present on the line; only the first MAX_ARGS are kept
+    int argCount;
+    int args[MAX_ARGS];
+    // Raw argument text of Snapshot and Restore (a path), pointing into
+    // the input buffer
+    const char* text;
+    int textLength;
+    // The line mentions Quit, which ends the input
+    bool stop;
+    
+    Command() : type(CMD_UNKNOWN), argCount(0), text(nullptr), textLength(0), stop(false) {}
+};
+
+// Fixed-width binary form of a command, used by binary input files and the
+// journal. Snapshot and Restore carry text and have no binary form.
+struct CommandRecord {
+    enum { STOP = 1 };
+    
+    uint8_t type;
+    // Arguments present, saturated at 255; only MAX_ARGS are stored
+    uint8_t argCount;
+    uint8_t flags;
+    uint8_t reserved;
+    int32_t args[Command::MAX_ARGS];
+};
+
+// Encode a command; returns false for commands with no binary form
+bool encodeCommand(const Command& command, CommandRecord& record);
+// Decode a record; unknown types decode as CMD_UNKNOWN
+void decodeCommand(const CommandRecord& record, Command& command);
+
+// Decode a trimmed, non-empty line "Name(a, b, ...)". Returns false if the
+// line has no '(' or an argument is not a number. Snapshot(path) and
+// Restore(path) keep their argument as text instead.
+bool parseCommandLine(const char* begin, const char* end, Command& command);
+
+// Read-only memory mapping of a whole file
+class MappedFile {
+private:
+    const char* data;
+    size_t length;
+    
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+
+public:
+    MappedFile() : data(nullptr), length(0) {}
+    ~MappedFile();
+    
+    // Map path; returns false if it cannot be opened
+    bool open(const std::string& path);
+    
+    const char* begin() const { return data; }
+    const char* end() const { return data + length; }
+};
+
+// Walks a buffer line by line, decoding commands without copying
+class CommandReader {
+private:
+    const char* pos;
+    const char* limit;
+
+public:
+    CommandReader(const char* begin, const char* end) : pos(begin), limit(end) {}
+    
+    // Decode the next non-empty line; lines that do not parse come back as
+    // CMD_UNKNOWN. Returns false at end of input.
+    bool next(Command& command);
+};
+
+// Binary input file: a header (magic, version, record size, 0) followed by
+// CommandRecords
+const uint32_t BINARY_COMMANDS_MAGIC = 0x43534147;    // "GASC" read little-endian
+const uint32_t BINARY_COMMANDS_VERSION = 1;
+const size_t BINARY_COMMANDS_HEADER = 4 * sizeof(uint32_t);
+
+// Header words of a binary input file
+void binaryCommandsHeader(uint32_t header[4]);
+// Check whether a buffer starts with a binary input header
+bool isBinaryCommands(const char* begin, const char* end);
+
+// Walks the records of a binary input file; a torn final record is ignored
+class BinaryCommandReader {
+private:
+    const char* pos;
+    const char* limit;
+
+public:
+    // begin and end span the whole file, header included
+    BinaryCommandReader(const char* begin, const char* end)
+        : pos(begin + BINARY_COMMANDS_HEADER), limit(end) {}
+    
+    // Decode the next record. Returns false at end of input.
+    bool next(Command& command) {
+        if ((size_t)(limit - pos) < sizeof(CommandRecord)) return false;
+        
+        CommandRecord record;
+        std::memcpy(&record, pos, sizeof(record));
+        pos += sizeof(record);
+        decodeCommand(record, command);
+        return true;
+    }
+};
+
+#endif // COMMAND_READER_H
@@ -0,0 +1,51 @@
+#include "CommandReader.h"
+#include <fstream>
+#include <iostream>
+#include <string>
+
+// Convert a text input file to the binary command format
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <input_file> <binary_output_file>" << std::endl;
+        return 1;
+    }
+    
+    MappedFile input;
+    if (!input.open(argv[1])) {
+        std::cerr << "Error opening input file: " << argv[1] << std::endl;
+        return 1;
+    }
+    
+    std::ofstream output(argv[2], std::ios::binary | std::ios::trunc);
+    if (!output.is_open()) {
+        std::cerr << "Error opening output file: " << argv[2] << std::endl;
+        return 1;
+    }
+    
+    uint32_t header[4];
+    binaryCommandsHeader(header);
+    output.write(reinterpret_cast<const char*>(header), sizeof(header));
+    
+    // Every line is kept, including unknown ones and any after Quit, so
+    // the binary file runs exactly like the text one
+    CommandReader reader(input.begin(), input.end());
+    Command command;
+    CommandRecord record;
+    long records = 0;
+    while (reader.next(command)) {
+        if (!encodeCommand(command, record)) {
+            std::cerr << "Command " << records + 1 << " (" << commandName(command.type)
+                      << ") has no binary form" << std::endl;
+            return 1;
+        }
+        output.write(reinterpret_cast<const char*>(&record), sizeof(record));
+        records++;
+    }
+    
+    output.flush();
+    if (!output) {
+        std::cerr << "Error writing output file: " << argv[2] << std::endl;
+        return 1;
+    }
+    return 0;
+}
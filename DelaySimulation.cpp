@@ -0,0 +1,109 @@
+#include "DelaySimulation.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+namespace {
+
+// splitmix64 finalizer
+uint64_t mix(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+// Uniform in (0, 1) from the top 53 bits
+double unit(uint64_t x) {
+    return ((x >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+// Standard normal draw for (seed, trial, flightID), by Box-Muller
+double normalDraw(uint64_t seed, int trial, int flightID) {
+    uint64_t key = mix(seed ^ mix(((uint64_t)(uint32_t)trial << 32) | (uint32_t)flightID));
+    double u1 = unit(key);
+    double u2 = unit(mix(key));
+    return std::sqrt(-2.0 * std::log(u1)) * std::cos(6.283185307179586 * u2);
+}
+
+// Value at quantile q of sorted samples
+int percentile(const std::vector<int>& sorted, double q) {
+    size_t i = (size_t)(q * (sorted.size() - 1) + 0.5);
+    return sorted[i];
+}
+
+} // namespace
+
+DelaySimulation::DelaySimulation(ThreadPool& p) : pool(p), trialCount(0) {
+    for (int i = 0; i < pool.threads(); i++) {
+        replicas.push_back(std::unique_ptr<Scheduler>(new Scheduler()));
+    }
+}
+
+// Reset the replica, redraw durations and replan, then read back the ETA
+// of every planned flight; none lands or leaves during a trial
+void DelaySimulation::runTrial(const Scheduler& base, Scheduler& replica, int trial,
+                               double sigma, uint64_t seed) {
+    replica.copyFrom(base);
+    replica.redrawDurations([trial, sigma, seed](int flightID, int duration) {
+        double factor = std::exp(sigma * normalDraw(seed, trial, flightID));
+        return std::max(1, (int)(duration * factor + 0.5));
+    });
+    
+    int* row = &etas[(size_t)trial * planned.size()];
+    for (size_t f = 0; f < planned.size(); f++) {
+        row[f] = replica.flightETA(planned[f].second);
+    }
+}
+
+// Each pool thread runs every threads-th trial on its own replica
+void DelaySimulation::run(const Scheduler& base, int trials, double sigma, uint64_t seed) {
+    planned.clear();
+    base.collectScheduled(INT_MIN, INT_MAX, planned);
+    trialCount = trials;
+    etas.resize((size_t)trials * planned.size());
+    if (planned.empty()) return;
+    
+    size_t threads = replicas.size();
+    pool.run(threads, [this, &base, trials, sigma, seed, threads](size_t t) {
+        for (int trial = (int)t; trial < trials; trial += (int)threads) {
+            runTrial(base, *replicas[t], trial, sigma, seed);
+        }
+    });
+}
+
+// Gather each flight's column and sort it, flights striped across the pool
+void DelaySimulation::percentiles(std::vector<EtaPercentiles>& out) {
+    out.assign(planned.size(), EtaPercentiles());
+    if (trialCount == 0) return;
+    
+    size_t threads = replicas.size();
+    pool.run(threads, [this, &out, threads](size_t t) {
+        std::vector<int> samples(trialCount);
+        for (size_t f = t; f < planned.size(); f += threads) {
+            for (int trial = 0; trial < trialCount; trial++) {
+                samples[trial] = etas[(size_t)trial * planned.size() + f];
+            }
+            std::sort(samples.begin(), samples.end());
+            
+            EtaPercentiles& result = out[f];
+            result.flightID = planned[f].second;
+            result.plannedETA = planned[f].first;
+            result.p50 = percentile(samples, 0.5);
+            result.p90 = percentile(samples, 0.9);
+            result.p99 = percentile(samples, 0.99);
+            result.latest = samples.back();
+        }
+    });
+}
+
+// One line per flight
+void DelaySimulation::print(const std::vector<EtaPercentiles>& results,
+                            OutputSink& output) {
+    for (const EtaPercentiles& result : results) {
+        output << "Flight " << result.flightID << " planned ETA " << result.plannedETA
+               << " p50 " << result.p50 << " p90 " << result.p90 << " p99 " << result.p99
+               << " latest " << result.latest;
+        output.endl();
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef DELAY_SIMULATION_H
+#define DELAY_SIMULATION_H
+
+#include "Scheduler.h"
+#include "ThreadPool.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// ETA spread of one flight over the trials of a run
+struct EtaPercentiles {
+    int flightID;
+    int plannedETA;
+    int p50;
+    int p90;
+    int p99;
+    int latest;
+};
+
+// Monte Carlo delay propagation over a scheduler's current state. Each
+// trial gives every flight not yet started a duration scaled by a
+// log-normal factor exp(sigma * z) and replans them with the scheduler's
+// own greedy pass. Trials are striped across a caller's thread pool. Each
+// pool thread keeps one scheduler replica for the simulation's lifetime,
+// reset from the base by copyFrom() before every trial, so its heap arena
+// and containers are reused across trials and runs. Factors depend only
+// on (seed, trial, flightID), so results do not depend on the thread
+// count.
+class DelaySimulation {
+private:
+    ThreadPool& pool;
+    std::vector<std::unique_ptr<Scheduler>> replicas;
+    // (ETA, flightID) of flights not yet started in the last run's base plan
+    std::vector<std::pair<int, int>> planned;
+    int trialCount;
+    // ETA of planned[f] in trial t at etas[t * planned.size() + f]
+    std::vector<int> etas;
+    
+    DelaySimulation(const DelaySimulation&);
+    DelaySimulation& operator=(const DelaySimulation&);
+    
+    // Run one trial on a replica and record its ETAs
+    void runTrial(const Scheduler& base, Scheduler& replica, int trial, double sigma,
+                  uint64_t seed);
+
+public:
+    // Trials run on pool, which must outlive the simulation
+    explicit DelaySimulation(ThreadPool& pool);
+    
+    // Flights the last run followed
+    size_t flightCount() const { return planned.size(); }
+    // Run trials from base, replacing the previous run's samples
+    void run(const Scheduler& base, int trials, double sigma, uint64_t seed);
+    // Per-flight ETA percentiles of the last run, in planned ETA order
+    void percentiles(std::vector<EtaPercentiles>& out);
+    // One line per flight: planned ETA, then p50/p90/p99 and latest ETA
+    static void print(const std::vector<EtaPercentiles>& results, OutputSink& output);
+};
+
+#endif // DELAY_SIMULATION_H
@@ -35,4 +35,31 @@ struct Flight {
           state(PENDING) {}
 };
 
+// Greedy assignment order: higher priority, then earlier submit, then smaller ID
+struct PlanKey {
+    int priority;
+    int submitTime;
+    int flightID;
+    
+    PlanKey() : priority(0), submitTime(0), flightID(0) {}
+    
+    PlanKey(const Flight& f) 
+        : priority(f.priority), submitTime(f.submitTime), flightID(f.flightID) {}
+    
+    // Negation with wraparound, so INT_MIN maps to itself as it always has
+    // in the pending queue's ordering
+    static int negated(int value) {
+        return (int)(0u - (unsigned)value);
+    }
+    
+    // True if this key is assigned a runway before the other
+    bool precedes(const PlanKey& other) const {
+        if (priority != other.priority) return priority > other.priority;
+        if (submitTime != other.submitTime) {
+            return negated(submitTime) > negated(other.submitTime);
+        }
+        return negated(flightID) > negated(other.flightID);
+    }
+};
+
 #endif // FLIGHT_H
\ No newline at end of file
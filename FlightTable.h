@@ -0,0 +1,182 @@
+#ifndef FLIGHT_TABLE_H
+#define FLIGHT_TABLE_H
+
+#include "Flight.h"
+#include <vector>
+
+// Active flights stored column-wise in dense slots [0, size()), with an
+// open-addressing flightID -> slot index. Erasing moves the last flight
+// into the freed slot, so sweeps over the columns never see holes.
+class FlightTable {
+private:
+    // Linear-probing index; capacity is a power of two. A bucket is empty
+    // when its slot is -1, so every int is a valid flightID.
+    std::vector<int> indexKeys;
+    std::vector<int> indexSlots;
+    size_t indexMask;
+    
+    // Home bucket of a flightID
+    size_t bucket(int flightID) const {
+        return ((unsigned)flightID * 2654435761u) & indexMask;
+    }
+    
+    // Bucket holding flightID, or the empty bucket where it would go
+    size_t probe(int flightID) const {
+        size_t i = bucket(flightID);
+        while (indexSlots[i] != -1 && indexKeys[i] != flightID) {
+            i = (i + 1) & indexMask;
+        }
+        return i;
+    }
+    
+    // Double the index when it passes half full
+    void growIndex() {
+        std::vector<int> oldKeys;
+        oldKeys.swap(indexKeys);
+        std::vector<int> oldSlots;
+        oldSlots.swap(indexSlots);
+        
+        indexKeys.assign(oldKeys.size() * 2, 0);
+        indexSlots.assign(oldKeys.size() * 2, -1);
+        indexMask = indexKeys.size() - 1;
+        
+        for (size_t i = 0; i < oldKeys.size(); i++) {
+            if (oldSlots[i] != -1) {
+                size_t j = probe(oldKeys[i]);
+                indexKeys[j] = oldKeys[i];
+                indexSlots[j] = oldSlots[i];
+            }
+        }
+    }
+    
+    // Remove a key with backward-shift deletion (no tombstones)
+    void eraseKey(int flightID) {
+        size_t hole = probe(flightID);
+        if (indexSlots[hole] == -1) return;
+        
+        size_t i = hole;
+        while (true) {
+            i = (i + 1) & indexMask;
+            if (indexSlots[i] == -1) break;
+            
+            // Shift back entries whose home bucket does not lie in (hole, i]
+            size_t home = bucket(indexKeys[i]);
+            bool movable = (hole <= i) ? (home <= hole || home > i)
+                                       : (home <= hole && home > i);
+            if (movable) {
+                indexKeys[hole] = indexKeys[i];
+                indexSlots[hole] = indexSlots[i];
+                hole = i;
+            }
+        }
+        indexSlots[hole] = -1;
+    }
+
+public:
+    // Columns, indexed by slot
+    std::vector<int> flightIDs;
+    std::vector<int> airlineIDs;
+    std::vector<int> submitTimes;
+    std::vector<int> priorities;
+    std::vector<int> durations;
+    std::vector<int> runwayIDs;
+    std::vector<int> startTimes;
+    std::vector<int> ETAs;
+    std::vector<unsigned char> states;
+    
+    FlightTable()
+        : indexKeys(16, 0), indexSlots(16, -1), indexMask(15) {}
+    
+    // Number of stored flights
+    size_t size() const {
+        return flightIDs.size();
+    }
+    
+    // Check if the table is empty
+    bool empty() const {
+        return flightIDs.empty();
+    }
+    
+    // Slot of a flight, or -1 if absent
+    int find(int flightID) const {
+        size_t i = probe(flightID);
+        return indexSlots[i];
+    }
+    
+    // Append a flight (its ID must not be present) and return its slot
+    int insert(const Flight& flight) {
+        if ((size() + 1) * 2 > indexKeys.size()) {
+            growIndex();
+        }
+        
+        int slot = (int)size();
+        flightIDs.push_back(flight.flightID);
+        airlineIDs.push_back(flight.airlineID);
+        submitTimes.push_back(flight.submitTime);
+        priorities.push_back(flight.priority);
+        durations.push_back(flight.duration);
+        runwayIDs.push_back(flight.runwayID);
+        startTimes.push_back(flight.startTime);
+        ETAs.push_back(flight.ETA);
+        states.push_back(flight.state);
+        
+        size_t i = probe(flight.flightID);
+        indexKeys[i] = flight.flightID;
+        indexSlots[i] = slot;
+        return slot;
+    }
+    
+    // Remove the flight in slot; the last flight moves into it.
+    // Returns the slot the moved flight came from, or -1 if none moved.
+    int erase(int slot) {
+        eraseKey(flightIDs[slot]);
+        
+        int last = (int)size() - 1;
+        if (slot != last) {
+            flightIDs[slot] = flightIDs[last];
+            airlineIDs[slot] = airlineIDs[last];
+            submitTimes[slot] = submitTimes[last];
+            priorities[slot] = priorities[last];
+            durations[slot] = durations[last];
+            runwayIDs[slot] = runwayIDs[last];
+            startTimes[slot] = startTimes[last];
+            ETAs[slot] = ETAs[last];
+            states[slot] = states[last];
+            indexSlots[probe(flightIDs[slot])] = slot;
+        }
+        
+        flightIDs.pop_back();
+        airlineIDs.pop_back();
+        submitTimes.pop_back();
+        priorities.pop_back();
+        durations.pop_back();
+        runwayIDs.pop_back();
+        startTimes.pop_back();
+        ETAs.pop_back();
+        states.pop_back();
+        
+        return slot != last ? last : -1;
+    }
+    
+    // Copy a flight out as a record
+    Flight get(int slot) const {
+        Flight flight(flightIDs[slot], airlineIDs[slot], submitTimes[slot],
+                      priorities[slot], durations[slot]);
+        flight.runwayID = runwayIDs[slot];
+        flight.startTime = startTimes[slot];
+        flight.ETA = ETAs[slot];
+        flight.state = (FlightState)states[slot];
+        return flight;
+    }
+    
+    // Greedy-order key of a flight
+    PlanKey planKey(int slot) const {
+        PlanKey key;
+        key.priority = priorities[slot];
+        key.submitTime = submitTimes[slot];
+        key.flightID = flightIDs[slot];
+        return key;
+    }
+};
+
+#endif // FLIGHT_TABLE_H
@@ -0,0 +1,149 @@
+#ifndef INDEXED_MIN_HEAP_H
+#define INDEXED_MIN_HEAP_H
+
+#include <algorithm>
+#include <vector>
+#include <unordered_map>
+#include <utility>
+
+// Implicit d-ary min-heap (binary by default) whose elements are addressed
+// by an integer ID, so any element can be erased or re-keyed in O(log n).
+// A wider node makes the tree shallower, trading comparisons on the way
+// down for fewer levels and cache lines on the way up.
+template<typename T, int Arity = 2>
+class IndexedMinHeap {
+private:
+    struct Node {
+        int id;
+        T value;
+        
+        Node(int i, const T& v) : id(i), value(v) {}
+    };
+    
+    std::vector<Node> heap;
+    // ID -> index in heap
+    std::unordered_map<int, int> position;
+    
+    // Get parent index
+    int parent(int i) { return (i - 1) / Arity; }
+    // Get first child index
+    int firstChild(int i) { return Arity * i + 1; }
+    
+    // Swap two nodes and keep the position map in sync
+    void swapNodes(int i, int j) {
+        std::swap(heap[i], heap[j]);
+        position[heap[i].id] = i;
+        position[heap[j].id] = j;
+    }
+    
+    // Move element up to maintain heap property
+    void heapifyUp(int i) {
+        while (i > 0 && heap[parent(i)].value > heap[i].value) {
+            swapNodes(i, parent(i));
+            i = parent(i);
+        }
+    }
+    
+    // Move element down to maintain heap property
+    void heapifyDown(int i) {
+        while (true) {
+            int smallest = i;
+            int first = firstChild(i);
+            int end = std::min(first + Arity, (int)heap.size());
+            
+            for (int child = first; child < end; child++) {
+                if (heap[child].value < heap[smallest].value)
+                    smallest = child;
+            }
+            
+            if (smallest == i) break;
+            swapNodes(i, smallest);
+            i = smallest;
+        }
+    }
+    
+    // Remove the node at index i
+    void removeAt(int i) {
+        int last = (int)heap.size() - 1;
+        position.erase(heap[i].id);
+        if (i != last) {
+            heap[i] = heap[last];
+            position[heap[i].id] = i;
+        }
+        heap.pop_back();
+        if (i < (int)heap.size()) {
+            heapifyUp(i);
+            heapifyDown(i);
+        }
+    }
+
+public:
+    IndexedMinHeap() {}
+    
+    // Insert element under id (id must not be present)
+    void push(int id, const T& value) {
+        heap.push_back(Node(id, value));
+        position[id] = (int)heap.size() - 1;
+        heapifyUp((int)heap.size() - 1);
+    }
+    
+    // Replace the value stored under id, inserting it if absent
+    void update(int id, const T& value) {
+        auto it = position.find(id);
+        if (it == position.end()) {
+            push(id, value);
+            return;
+        }
+        int i = it->second;
+        heap[i].value = value;
+        heapifyUp(i);
+        heapifyDown(i);
+    }
+    
+    // Remove element stored under id, if any
+    void erase(int id) {
+        auto it = position.find(id);
+        if (it != position.end()) {
+            removeAt(it->second);
+        }
+    }
+    
+    // Check if id is in the heap
+    bool contains(int id) const {
+        return position.find(id) != position.end();
+    }
+    
+    // Get minimum element
+    const T& top() const {
+        return heap[0].value;
+    }
+    
+    // Get ID of minimum element
+    int topID() const {
+        return heap[0].id;
+    }
+    
+    // Remove minimum element
+    void pop() {
+        if (heap.empty()) return;
+        removeAt(0);
+    }
+    
+    // Check if heap is empty
+    bool empty() const {
+        return heap.empty();
+    }
+    
+    // Get heap size
+    size_t size() const {
+        return heap.size();
+    }
+    
+    // Clear all elements
+    void clear() {
+        heap.clear();
+        position.clear();
+    }
+};
+
+#endif // INDEXED_MIN_HEAP_H
@@ -0,0 +1,261 @@
+#ifndef INDEXED_RADIX_HEAP_H
+#define INDEXED_RADIX_HEAP_H
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Radix heap with the IndexedMinHeap interface, for values ordered first
+// by an integer time, queueTime(value), that mostly only moves forward.
+// Bucket b >= 1 holds values whose time first differs from the last
+// popped time (last) in bit b - 1; bucket 0 holds values at last as a
+// binary heap on the full value, so a burst of equal times costs
+// O(log n) per push and pop rather than a shift of the whole bucket. A
+// pop from an empty bucket 0 moves last to the minimum and spreads its
+// bucket over lower ones, so each value is moved O(log range) times. A
+// push below last (time moved backwards) rebuilds the buckets around the
+// new time.
+template<typename T>
+class IndexedRadixHeap {
+private:
+    struct Node {
+        int id;
+        T value;
+        
+        Node(int i, const T& v) : id(i), value(v) {}
+    };
+    
+    static const int BUCKETS = 33;
+    std::vector<Node> buckets[BUCKETS];
+    // ID -> (bucket, index in bucket)
+    std::unordered_map<int, std::pair<int, int>> position;
+    uint32_t last;
+    size_t count;
+    // Location of the minimum while bucket 0 is empty (minBucket -1 when unknown)
+    mutable int minBucket;
+    mutable int minIndex;
+    
+    // Time mapped to unsigned with its order kept
+    static uint32_t keyOf(const T& value) {
+        return (uint32_t)queueTime(value) ^ 0x80000000u;
+    }
+    
+    // Number of significant bits in a non-zero value
+    static int bitWidth(uint32_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+        return 32 - __builtin_clz(x);
+#else
+        int width = 0;
+        while (x) {
+            x >>= 1;
+            width++;
+        }
+        return width;
+#endif
+    }
+    
+    int bucketOf(uint32_t key) const {
+        return key == last ? 0 : bitWidth(key ^ last);
+    }
+    
+    // Heap order for bucket 0: the minimum is at the front
+    static bool after(const Node& a, const Node& b) {
+        return b.value < a.value;
+    }
+    
+    // Record positions of bucket b from index i on
+    void reindex(int b, int i) {
+        for (; i < (int)buckets[b].size(); i++) {
+            position[buckets[b][i].id] = std::make_pair(b, i);
+        }
+    }
+    
+    // Move bucket 0's node at i up to its heap position
+    void siftUp(int i) {
+        std::vector<Node>& heap = buckets[0];
+        Node node = heap[i];
+        while (i > 0) {
+            int parent = (i - 1) / 2;
+            if (!(node.value < heap[parent].value)) break;
+            heap[i] = heap[parent];
+            position[heap[i].id] = std::make_pair(0, i);
+            i = parent;
+        }
+        heap[i] = node;
+        position[node.id] = std::make_pair(0, i);
+    }
+    
+    // Move bucket 0's node at i down to its heap position
+    void siftDown(int i) {
+        std::vector<Node>& heap = buckets[0];
+        int n = (int)heap.size();
+        Node node = heap[i];
+        while (true) {
+            int child = 2 * i + 1;
+            if (child >= n) break;
+            if (child + 1 < n && heap[child + 1].value < heap[child].value) child++;
+            if (!(heap[child].value < node.value)) break;
+            heap[i] = heap[child];
+            position[heap[i].id] = std::make_pair(0, i);
+            i = child;
+        }
+        heap[i] = node;
+        position[node.id] = std::make_pair(0, i);
+    }
+    
+    // Put a node in the bucket for its key relative to last
+    void place(const Node& node) {
+        int b = bucketOf(keyOf(node.value));
+        std::vector<Node>& bucket = buckets[b];
+        if (b == 0) {
+            bucket.push_back(node);
+            siftUp((int)bucket.size() - 1);
+        } else {
+            bucket.push_back(node);
+            position[node.id] = std::make_pair(b, (int)bucket.size() - 1);
+        }
+    }
+    
+    // Find the minimum when bucket 0 is empty: scan the lowest non-empty bucket
+    void findMin() const {
+        if (minBucket >= 0) return;
+        int b = 1;
+        while (buckets[b].empty()) b++;
+        const std::vector<Node>& bucket = buckets[b];
+        int best = 0;
+        for (int i = 1; i < (int)bucket.size(); i++) {
+            if (bucket[i].value < bucket[best].value) best = i;
+        }
+        minBucket = b;
+        minIndex = best;
+    }
+    
+    // Move last to the minimum's time and spread its bucket
+    void refill() {
+        findMin();
+        std::vector<Node> moved;
+        moved.swap(buckets[minBucket]);
+        last = keyOf(moved[minIndex].value);
+        minBucket = -1;
+        for (const Node& node : moved) {
+            int b = bucketOf(keyOf(node.value));
+            buckets[b].push_back(node);
+            if (b != 0) {
+                position[node.id] = std::make_pair(b, (int)buckets[b].size() - 1);
+            }
+        }
+        std::make_heap(buckets[0].begin(), buckets[0].end(), after);
+        reindex(0, 0);
+    }
+    
+    // Re-bucket everything around an earlier time
+    void rebase(uint32_t key) {
+        std::vector<Node> all;
+        all.reserve(count);
+        for (std::vector<Node>& bucket : buckets) {
+            all.insert(all.end(), bucket.begin(), bucket.end());
+            bucket.clear();
+        }
+        last = key;
+        for (const Node& node : all) {
+            place(node);
+        }
+    }
+    
+    // Remove the node at index i of bucket b
+    void removeAt(int b, int i) {
+        std::vector<Node>& bucket = buckets[b];
+        position.erase(bucket[i].id);
+        int back = (int)bucket.size() - 1;
+        if (i != back) {
+            bucket[i] = bucket[back];
+            position[bucket[i].id] = std::make_pair(b, i);
+        }
+        bucket.pop_back();
+        if (b == 0 && i != back) {
+            siftDown(i);
+            siftUp(i);
+        }
+        count--;
+        minBucket = -1;
+    }
+    
+    const Node& minNode() const {
+        if (!buckets[0].empty()) return buckets[0].front();
+        findMin();
+        return buckets[minBucket][minIndex];
+    }
+
+public:
+    IndexedRadixHeap() : last(0), count(0), minBucket(-1), minIndex(0) {}
+    
+    // Insert element under id (id must not be present)
+    void push(int id, const T& value) {
+        uint32_t key = keyOf(value);
+        if (key < last) rebase(key);
+        place(Node(id, value));
+        count++;
+        minBucket = -1;
+    }
+    
+    // Replace the value stored under id, inserting it if absent
+    void update(int id, const T& value) {
+        erase(id);
+        push(id, value);
+    }
+    
+    // Remove element stored under id, if any
+    void erase(int id) {
+        auto it = position.find(id);
+        if (it != position.end()) {
+            removeAt(it->second.first, it->second.second);
+        }
+    }
+    
+    // Check if id is in the heap
+    bool contains(int id) const {
+        return position.find(id) != position.end();
+    }
+    
+    // Get minimum element
+    const T& top() const {
+        return minNode().value;
+    }
+    
+    // Get ID of minimum element
+    int topID() const {
+        return minNode().id;
+    }
+    
+    // Remove minimum element
+    void pop() {
+        if (count == 0) return;
+        if (buckets[0].empty()) refill();
+        removeAt(0, 0);
+    }
+    
+    // Check if heap is empty
+    bool empty() const {
+        return count == 0;
+    }
+    
+    // Get heap size
+    size_t size() const {
+        return count;
+    }
+    
+    // Clear all elements
+    void clear() {
+        for (std::vector<Node>& bucket : buckets) {
+            bucket.clear();
+        }
+        position.clear();
+        last = 0;
+        count = 0;
+        minBucket = -1;
+    }
+};
+
+#endif // INDEXED_RADIX_HEAP_H
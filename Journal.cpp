@@ -0,0 +1,186 @@
+#include "Journal.h"
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+const size_t HEADER_BYTES = 4 * sizeof(uint32_t);
+
+// Checkpoint file that goes with a journal
+std::string checkpointPath(const std::string& journalPath) {
+    return journalPath + ".checkpoint";
+}
+
+// Write all of data at the end of the file
+bool writeAll(int fd, const void* data, size_t length) {
+    const char* p = static_cast<const char*>(data);
+    while (length > 0) {
+        ssize_t n = ::write(fd, p, length);
+        if (n <= 0) return false;
+        p += n;
+        length -= n;
+    }
+    return true;
+}
+
+} // namespace
+
+Journal::~Journal() {
+    if (fd >= 0) {
+        commit();
+        ::close(fd);
+    }
+}
+
+// Commands that change state; prints, Stats, Quit and snapshots do not
+bool Journal::journaled(const Command& command) {
+    switch (command.type) {
+    case CMD_INITIALIZE:
+    case CMD_SUBMIT_FLIGHT:
+    case CMD_CANCEL_FLIGHT:
+    case CMD_REPRIORITIZE:
+    case CMD_ADD_RUNWAYS:
+    case CMD_GROUND_HOLD:
+    case CMD_TICK:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Truncate to a bare header carrying newGeneration
+bool Journal::reset(uint32_t newGeneration) {
+    uint32_t header[4] = {
+        JOURNAL_MAGIC, JOURNAL_VERSION, (uint32_t)sizeof(CommandRecord), newGeneration
+    };
+    if (::ftruncate(fd, 0) != 0 || !writeAll(fd, header, sizeof(header)) ||
+        ::fdatasync(fd) != 0) {
+        return false;
+    }
+    generation = newGeneration;
+    recordCount = 0;
+    return true;
+}
+
+// Start a fresh journal; a checkpoint left by an earlier run would not
+// match it, so it is removed
+bool Journal::create(const std::string& journalPath, size_t commitEvery) {
+    path = journalPath;
+    groupSize = commitEvery > 0 ? commitEvery : 1;
+    fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) return false;
+    
+    std::remove(checkpointPath(path).c_str());
+    return reset(0);
+}
+
+// Load the checkpoint if there is one, replay the journal records that
+// follow it, then reopen the journal for appending
+bool Journal::recover(const std::string& journalPath, size_t commitEvery,
+                      RunwayGroups& scheduler) {
+    path = journalPath;
+    groupSize = commitEvery > 0 ? commitEvery : 1;
+    
+    uint32_t checkpointGeneration = 0;
+    std::string checkpoint = checkpointPath(path);
+    if (::access(checkpoint.c_str(), F_OK) == 0 &&
+        !scheduler.loadSnapshot(checkpoint, checkpointGeneration)) {
+        return false;
+    }
+    
+    JournalReader reader;
+    bool haveJournal = ::access(path.c_str(), F_OK) == 0;
+    if (haveJournal && !reader.open(path)) return false;
+    if (haveJournal && reader.fileGeneration() > checkpointGeneration) return false;
+    
+    // A journal older than the checkpoint is already part of it
+    bool replay = haveJournal && reader.fileGeneration() == checkpointGeneration;
+    size_t replayed = 0;
+    if (replay) {
+        DiscardSink discard;
+        Command command;
+        while (reader.next(command)) {
+            scheduler.execute(command, discard);
+            replayed++;
+        }
+    }
+    
+    fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) return false;
+    if (!replay) {
+        return reset(checkpointGeneration);
+    }
+    
+    // Drop a torn final record so new records start on a boundary
+    generation = checkpointGeneration;
+    recordCount = replayed;
+    return ::ftruncate(fd, HEADER_BYTES + replayed * sizeof(CommandRecord)) == 0;
+}
+
+// Queue one record; a full group goes to disk with one sync
+bool Journal::append(const Command& command) {
+    CommandRecord record;
+    encodeCommand(command, record);
+    pending.push_back(record);
+    recordCount++;
+    if (pending.size() >= groupSize) {
+        return commit();
+    }
+    return true;
+}
+
+// Write queued records in one call and sync them
+bool Journal::commit() {
+    if (pending.empty()) return true;
+    
+    bool ok = writeAll(fd, pending.data(), pending.size() * sizeof(CommandRecord)) &&
+              ::fdatasync(fd) == 0;
+    pending.clear();
+    return ok;
+}
+
+// The checkpoint is written and renamed into place before the journal is
+// emptied; a crash in between leaves a journal of the older generation,
+// which recovery skips
+bool Journal::checkpoint(RunwayGroups& scheduler) {
+    if (!commit()) return false;
+    if (!scheduler.saveSnapshot(checkpointPath(path), generation + 1)) return false;
+    return reset(generation + 1);
+}
+
+// Map a journal and validate its header
+bool JournalReader::open(const std::string& path) {
+    if (!file.open(path)) return false;
+    
+    const char* begin = file.begin();
+    if ((size_t)(file.end() - begin) < HEADER_BYTES) return false;
+    
+    uint32_t header[4];
+    std::memcpy(header, begin, sizeof(header));
+    if (header[0] != JOURNAL_MAGIC || header[1] != JOURNAL_VERSION ||
+        header[2] != sizeof(CommandRecord)) {
+        return false;
+    }
+    
+    generation = header[3];
+    pos = begin + HEADER_BYTES;
+    limit = file.end();
+    return true;
+}
+
+// Decode the next whole record back into a command
+bool JournalReader::next(Command& command) {
+    if ((size_t)(limit - pos) < sizeof(CommandRecord)) return false;
+    
+    CommandRecord record;
+    std::memcpy(&record, pos, sizeof(record));
+    pos += sizeof(record);
+    
+    decodeCommand(record, command);
+    if (!Journal::journaled(command)) {
+        command.type = CMD_UNKNOWN;
+    }
+    return true;
+}
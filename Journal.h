@@ -0,0 +1,83 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include "CommandReader.h"
+#include "RunwayGroups.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Write-ahead journal of state-changing commands. Each command is one
+// CommandRecord; records are written and synced in groups, so one
+// fdatasync covers up to groupSize commands. A checkpoint saves the whole
+// state to <path>.checkpoint and empties the journal.
+//
+// Journal file: header (magic, version, record size, generation), then
+// records. The generation ties the journal to the checkpoint it extends:
+// a journal whose generation is older than the checkpoint's is already
+// contained in it (a crash between the two steps of a checkpoint).
+
+const uint32_t JOURNAL_MAGIC = 0x4a534147;    // "GASJ" read little-endian
+const uint32_t JOURNAL_VERSION = 2;
+
+class Journal {
+private:
+    int fd;
+    std::string path;
+    std::vector<CommandRecord> pending;
+    size_t groupSize;
+    uint32_t generation;
+    // Records written since the last checkpoint
+    size_t recordCount;
+    
+    Journal(const Journal&);
+    Journal& operator=(const Journal&);
+    
+    // Empty the journal file and stamp it with generation
+    bool reset(uint32_t newGeneration);
+
+public:
+    Journal() : fd(-1), groupSize(1), generation(0), recordCount(0) {}
+    ~Journal();
+    
+    // Commands that change state and are journaled
+    static bool journaled(const Command& command);
+    
+    // Start a fresh journal at path, removing any old checkpoint
+    bool create(const std::string& journalPath, size_t commitEvery);
+    // Rebuild scheduler from path's checkpoint and journal without output,
+    // then keep appending to the journal
+    bool recover(const std::string& journalPath, size_t commitEvery,
+                 RunwayGroups& scheduler);
+    
+    // Queue a journaled command; a full group is written and synced
+    bool append(const Command& command);
+    // Write and sync queued records
+    bool commit();
+    // Records since the last checkpoint
+    size_t sinceCheckpoint() const { return recordCount; }
+    // Save scheduler state as the next checkpoint and empty the journal
+    bool checkpoint(RunwayGroups& scheduler);
+};
+
+// Reads the records of a journal file in place
+class JournalReader {
+private:
+    MappedFile file;
+    const char* pos;
+    const char* limit;
+    uint32_t generation;
+
+public:
+    JournalReader() : pos(nullptr), limit(nullptr), generation(0) {}
+    
+    // Map path and check its header
+    bool open(const std::string& path);
+    // Generation from the header
+    uint32_t fileGeneration() const { return generation; }
+    // Decode the next record; false at the end (a torn final record is
+    // ignored)
+    bool next(Command& command);
+};
+
+#endif // JOURNAL_H
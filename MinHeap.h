@@ -80,46 +80,4 @@ public:
     }
 };
 
-// Runway structure for runway pool
-struct Runway {
-    int nextFreeTime;
-    int runwayID;
-    
-    Runway(int id, int time) : nextFreeTime(time), runwayID(id) {}
-    
-    bool operator>(const Runway& other) const {
-        if (nextFreeTime != other.nextFreeTime)
-            return nextFreeTime > other.nextFreeTime;
-        return runwayID > other.runwayID;
-    }
-    
-    bool operator<(const Runway& other) const {
-        if (nextFreeTime != other.nextFreeTime)
-            return nextFreeTime < other.nextFreeTime;
-        return runwayID < other.runwayID;
-    }
-};
-
-// Timetable entry for completions queue
-struct TimetableEntry {
-    int ETA;
-    int flightID;
-    int runwayID;
-    
-    TimetableEntry(int eta, int fid, int rid) 
-        : ETA(eta), flightID(fid), runwayID(rid) {}
-    
-    bool operator>(const TimetableEntry& other) const {
-        if (ETA != other.ETA)
-            return ETA > other.ETA;
-        return flightID > other.flightID;
-    }
-    
-    bool operator<(const TimetableEntry& other) const {
-        if (ETA != other.ETA)
-            return ETA < other.ETA;
-        return flightID < other.flightID;
-    }
-};
-
 #endif // MIN_HEAP_H
\ No newline at end of file
@@ -0,0 +1,148 @@
+#ifndef OUTPUT_SINK_H
+#define OUTPUT_SINK_H
+
+#include <cstring>
+#include <fstream>
+#include <string>
+
+// Buffered destination for scheduler output. Lines are written piecewise
+// with operator<< and ended with endl(); bytes reach the destination in
+// fixed-size chunks, so memory use does not grow with the output.
+class OutputSink {
+private:
+    enum { BUFFER_SIZE = 1 << 16 };
+    
+    char buffer[BUFFER_SIZE];
+    size_t used;
+    
+    // Copy bytes into the buffer, draining it whenever it fills
+    void append(const char* data, size_t length) {
+        while (length > 0) {
+            if (used == BUFFER_SIZE) {
+                flush();
+            }
+            size_t chunk = BUFFER_SIZE - used;
+            if (chunk > length) chunk = length;
+            std::memcpy(buffer + used, data, chunk);
+            used += chunk;
+            data += chunk;
+            length -= chunk;
+        }
+    }
+
+protected:
+    // Hand buffered bytes to the destination
+    virtual void drain(const char* data, size_t length) = 0;
+
+public:
+    OutputSink() : used(0) {}
+    virtual ~OutputSink() {}
+    
+    OutputSink& operator<<(const char* text) {
+        append(text, std::strlen(text));
+        return *this;
+    }
+    
+    OutputSink& operator<<(const std::string& text) {
+        append(text.data(), text.size());
+        return *this;
+    }
+    
+    OutputSink& operator<<(char c) {
+        if (used == BUFFER_SIZE) {
+            flush();
+        }
+        buffer[used++] = c;
+        return *this;
+    }
+    
+    // Format an integer in place, without building a string
+    OutputSink& operator<<(long long value) {
+        char digits[20];
+        char* end = digits + sizeof(digits);
+        char* p = end;
+        unsigned long long magnitude = value < 0 ? 0ull - (unsigned long long)value 
+                                                 : (unsigned long long)value;
+        do {
+            *--p = (char)('0' + magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude != 0);
+        if (value < 0) {
+            *--p = '-';
+        }
+        append(p, end - p);
+        return *this;
+    }
+    
+    OutputSink& operator<<(int value) {
+        return *this << (long long)value;
+    }
+    
+    // End the current line
+    void endl() {
+        *this << '\n';
+    }
+    
+    // Push buffered bytes to the destination
+    void flush() {
+        if (used > 0) {
+            drain(buffer, used);
+            used = 0;
+        }
+    }
+};
+
+// Output streamed to a file
+class FileSink : public OutputSink {
+private:
+    std::ofstream file;
+
+protected:
+    void drain(const char* data, size_t length) {
+        file.write(data, length);
+    }
+
+public:
+    explicit FileSink(const std::string& path) : file(path.c_str(), std::ios::binary) {}
+    
+    ~FileSink() {
+        flush();
+    }
+    
+    // Check if the file opened
+    bool isOpen() const {
+        return file.is_open();
+    }
+};
+
+// Output kept in memory, for callers that inspect it
+class StringSink : public OutputSink {
+private:
+    std::string text;
+
+protected:
+    void drain(const char* data, size_t length) {
+        text.append(data, length);
+    }
+
+public:
+    // Everything written so far
+    const std::string& str() {
+        flush();
+        return text;
+    }
+    
+    // Discard everything written so far
+    void clear() {
+        flush();
+        text.clear();
+    }
+};
+
+// Output formatted as usual and then dropped, for replay and benchmarks
+class DiscardSink : public OutputSink {
+protected:
+    void drain(const char*, size_t) {}
+};
+
+#endif // OUTPUT_SINK_H
@@ -2,23 +2,27 @@
 #define PAIRING_HEAP_H
 
 #include "Flight.h"
+#include <utility>
 #include <vector>
+#include <new>
 
 struct PairingNode {
     int priority;
     int negSubmitTime;
     int negFlightID;
-    Flight* flight;
+    int slot;               // FlightTable slot of the queued flight
     PairingNode* leftChild;
     PairingNode* nextSibling;
+    PairingNode* prev;      // Parent if leftmost child, else left sibling
     
-    PairingNode(Flight* f) 
-        : priority(f->priority), 
-          negSubmitTime(-f->submitTime), 
-          negFlightID(-f->flightID),
-          flight(f), 
+    PairingNode(const PlanKey& key, int s) 
+        : priority(key.priority), 
+          negSubmitTime(PlanKey::negated(key.submitTime)), 
+          negFlightID(PlanKey::negated(key.flightID)),
+          slot(s), 
           leftChild(nullptr), 
-          nextSibling(nullptr) {}
+          nextSibling(nullptr),
+          prev(nullptr) {}
     
     bool operator>(const PairingNode& other) const {
         if (priority != other.priority) return priority > other.priority;
@@ -28,8 +32,81 @@ struct PairingNode {
 };
 
 class PairingHeap {
+public:
+    typedef PairingNode Node;
+    typedef PairingNode* Handle;
+
 private:
     PairingNode* root;
+    size_t count;
+    
+    // Node arena: nodes are bump-allocated from fixed-size blocks that are
+    // kept for the heap's lifetime; freed nodes go on a free list
+    static const int BLOCK_SIZE = 1024;
+    std::vector<PairingNode*> blocks;
+    size_t activeBlock;
+    int blockUsed;
+    PairingNode* freeList;      // Chained through nextSibling
+    
+    // Take a node from the free list or the arena
+    PairingNode* allocate(const PlanKey& key, int slot) {
+        return new (rawNode()) PairingNode(key, slot);
+    }
+    
+    // Unconstructed node storage
+    PairingNode* rawNode() {
+        PairingNode* node;
+        if (freeList) {
+            node = freeList;
+            freeList = freeList->nextSibling;
+        } else {
+            if (activeBlock == blocks.size()) {
+                blocks.push_back(static_cast<PairingNode*>(
+                    ::operator new(BLOCK_SIZE * sizeof(PairingNode))));
+            }
+            node = blocks[activeBlock] + blockUsed++;
+            if (blockUsed == BLOCK_SIZE) {
+                activeBlock++;
+                blockUsed = 0;
+            }
+        }
+        return node;
+    }
+    
+    // Unlinked copy of a node's key and slot
+    PairingNode* copyNode(const PairingNode* source) {
+        PairingNode* node = new (rawNode()) PairingNode(*source);
+        node->leftChild = nullptr;
+        node->nextSibling = nullptr;
+        node->prev = nullptr;
+        return node;
+    }
+    
+    // Return a node to the free list
+    void release(PairingNode* node) {
+        node->nextSibling = freeList;
+        freeList = node;
+    }
+    
+    // Make child the leftmost child of parent
+    void attach(PairingNode* parent, PairingNode* child) {
+        child->nextSibling = parent->leftChild;
+        if (parent->leftChild) parent->leftChild->prev = child;
+        child->prev = parent;
+        parent->leftChild = child;
+    }
+    
+    // Unlink a non-root node (with its subtree) from the tree
+    void cut(PairingNode* node) {
+        if (node->prev->leftChild == node) {
+            node->prev->leftChild = node->nextSibling;
+        } else {
+            node->prev->nextSibling = node->nextSibling;
+        }
+        if (node->nextSibling) node->nextSibling->prev = node->prev;
+        node->nextSibling = nullptr;
+        node->prev = nullptr;
+    }
     
     // Merge two heap trees
     PairingNode* merge(PairingNode* h1, PairingNode* h2) {
@@ -37,12 +114,10 @@ private:
         if (!h2) return h1;
         
         if (*h1 > *h2) {
-            h2->nextSibling = h1->leftChild;
-            h1->leftChild = h2;
+            attach(h1, h2);
             return h1;
         } else {
-            h1->nextSibling = h2->leftChild;
-            h2->leftChild = h1;
+            attach(h2, h1);
             return h2;
         }
     }
@@ -51,79 +126,182 @@ private:
     PairingNode* mergePairs(PairingNode* node) {
         if (!node || !node->nextSibling) return node;
         
-        // Two-pass scheme
-        std::vector<PairingNode*> trees;
+        // Two-pass scheme without scratch storage: merged pairs are pushed
+        // onto a stack threaded through nextSibling, so the stack's head is
+        // the rightmost pair
+        PairingNode* stack = nullptr;
         
         // First pass: merge pairs left to right
         while (node) {
             PairingNode* first = node;
             PairingNode* second = node->nextSibling;
+            PairingNode* tree;
             
             if (second) {
                 node = second->nextSibling;
                 first->nextSibling = nullptr;
                 second->nextSibling = nullptr;
-                trees.push_back(merge(first, second));
+                tree = merge(first, second);
             } else {
                 node = nullptr;
-                trees.push_back(first);
+                tree = first;
             }
+            tree->nextSibling = stack;
+            stack = tree;
         }
         
         // Second pass: merge right to left
-        PairingNode* result = trees.back();
-        for (int i = trees.size() - 2; i >= 0; i--) {
-            result = merge(trees[i], result);
+        PairingNode* result = stack;
+        stack = stack->nextSibling;
+        result->nextSibling = nullptr;
+        while (stack) {
+            PairingNode* tree = stack;
+            stack = stack->nextSibling;
+            tree->nextSibling = nullptr;
+            result = merge(tree, result);
         }
         
         return result;
     }
     
-    // Recursively delete all nodes
-    void clearHelper(PairingNode* node) {
-        if (!node) return;
-        clearHelper(node->leftChild);
-        clearHelper(node->nextSibling);
-        delete node;
+    // Merge the children of a removed node into a single detached tree
+    PairingNode* mergeChildren(PairingNode* node) {
+        PairingNode* result = mergePairs(node->leftChild);
+        if (result) result->prev = nullptr;
+        return result;
     }
     
+    // Rebuild other's tree in this (empty) heap with freshly allocated nodes;
+    // nodes are copied breadth-first with an explicit queue, so deep trees
+    // cannot overflow the stack
+    void copyTree(const PairingHeap& other) {
+        if (!other.root) return;
+        root = copyNode(other.root);
+        count = other.count;
+        
+        std::vector<std::pair<const PairingNode*, PairingNode*>> queue;
+        queue.push_back(std::make_pair(other.root, root));
+        for (size_t i = 0; i < queue.size(); i++) {
+            const PairingNode* source = queue[i].first;
+            PairingNode* copy = queue[i].second;
+            PairingNode* previous = copy;
+            for (const PairingNode* child = source->leftChild; child; 
+                 child = child->nextSibling) {
+                PairingNode* childCopy = copyNode(child);
+                if (previous == copy) {
+                    copy->leftChild = childCopy;
+                } else {
+                    previous->nextSibling = childCopy;
+                }
+                childCopy->prev = previous;
+                previous = childCopy;
+                queue.push_back(std::make_pair(child, childCopy));
+            }
+        }
+    }
+
 public:
-    PairingHeap() : root(nullptr) {}
+    PairingHeap() 
+        : root(nullptr), count(0), activeBlock(0), blockUsed(0), freeList(nullptr) {}
+    
+    // A copy has the same tree in its own arena. Handles into the original
+    // do not carry over; visitNodes finds the new ones.
+    PairingHeap(const PairingHeap& other) 
+        : root(nullptr), count(0), activeBlock(0), blockUsed(0), freeList(nullptr) {
+        copyTree(other);
+    }
+    
+    // Assignment rewinds this heap's arena and copies into its blocks
+    PairingHeap& operator=(const PairingHeap& other) {
+        if (this != &other) {
+            clear();
+            copyTree(other);
+        }
+        return *this;
+    }
     
     ~PairingHeap() {
-        clear();
+        for (PairingNode* block : blocks) {
+            ::operator delete(block);
+        }
     }
     
-    // Delete all nodes
+    // Drop all nodes; the arena is rewound rather than walked, so this is
+    // O(1) with no recursion over the tree
     void clear() {
-        clearHelper(root);
         root = nullptr;
+        count = 0;
+        activeBlock = 0;
+        blockUsed = 0;
+        freeList = nullptr;
     }
     
-    // Insert flight into heap
-    PairingNode* push(Flight* flight) {
-        PairingNode* newNode = new PairingNode(flight);
+    // Call visit(node) for every node in the heap
+    template <class Visit>
+    void visitNodes(Visit visit) {
+        if (!root) return;
+        std::vector<PairingNode*> stack(1, root);
+        while (!stack.empty()) {
+            PairingNode* node = stack.back();
+            stack.pop_back();
+            visit(node);
+            if (node->nextSibling) stack.push_back(node->nextSibling);
+            if (node->leftChild) stack.push_back(node->leftChild);
+        }
+    }
+    
+    // Insert flight slot under its greedy key; the returned handle stays
+    // valid until the node is popped or erased
+    PairingNode* push(const PlanKey& key, int slot) {
+        PairingNode* newNode = allocate(key, slot);
         root = merge(root, newNode);
+        count++;
         return newNode;
     }
     
-    // Get minimum priority flight
-    Flight* top() {
-        return root ? root->flight : nullptr;
+    // Get slot of the first flight in greedy order (-1 if empty)
+    int top() {
+        return root ? root->slot : -1;
     }
     
-    // Remove and return minimum
+    // Remove the first flight in greedy order (highest priority)
     void pop() {
         if (!root) return;
         PairingNode* oldRoot = root;
-        root = mergePairs(root->leftChild);
-        delete oldRoot;
+        root = mergeChildren(oldRoot);
+        release(oldRoot);
+        count--;
+    }
+    
+    // Raise a node's priority in place
+    void increaseKey(PairingNode* node, int newPriority) {
+        node->priority = newPriority;
+        if (node == root) return;
+        cut(node);
+        root = merge(root, node);
+    }
+    
+    // Remove an arbitrary node
+    void erase(PairingNode* node) {
+        if (node == root) {
+            pop();
+            return;
+        }
+        cut(node);
+        root = merge(root, mergeChildren(node));
+        release(node);
+        count--;
     }
     
     // Check if heap is empty
     bool empty() const {
         return root == nullptr;
     }
+    
+    // Get number of nodes
+    size_t size() const {
+        return count;
+    }
 };
 
 #endif // PAIRING_HEAP_H
\ No newline at end of file
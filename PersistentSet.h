@@ -0,0 +1,186 @@
+#ifndef PERSISTENT_SET_H
+#define PERSISTENT_SET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+// Ordered set with path copying. Insert and erase copy only the nodes on
+// the path to the change and share every other node with the version they
+// started from, so copying a set is O(1) and a copy never changes. A copy
+// can be handed to other threads and read without locks while the owner
+// keeps updating its own. Balanced as a treap; node weights come from a
+// per-set xorshift generator, so layouts are deterministic.
+template<typename T, typename Less = std::less<T>>
+class PersistentSet {
+private:
+    struct Node;
+    typedef std::shared_ptr<const Node> NodePtr;
+    
+    struct Node {
+        T value;
+        uint32_t weight;
+        NodePtr left;
+        NodePtr right;
+        
+        Node(const T& v, uint32_t w, const NodePtr& l, const NodePtr& r)
+            : value(v), weight(w), left(l), right(r) {}
+    };
+    
+    NodePtr root;
+    size_t count;
+    uint32_t seed;
+    
+    uint32_t nextWeight() {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        return seed;
+    }
+    
+    static NodePtr make(const T& value, uint32_t weight, const NodePtr& left,
+                        const NodePtr& right) {
+        return NodePtr(std::make_shared<Node>(value, weight, left, right));
+    }
+    
+    // Copy of node's subtree with value added or replaced; a new node that
+    // outweighs its parent is rotated above it
+    static NodePtr insertAt(const NodePtr& node, const T& value, uint32_t weight,
+                            bool& added) {
+        if (!node) {
+            added = true;
+            return make(value, weight, nullptr, nullptr);
+        }
+        
+        Less less;
+        if (less(value, node->value)) {
+            NodePtr left = insertAt(node->left, value, weight, added);
+            if (left->weight > node->weight) {
+                return make(left->value, left->weight, left->left,
+                            make(node->value, node->weight, left->right, node->right));
+            }
+            return make(node->value, node->weight, left, node->right);
+        }
+        if (less(node->value, value)) {
+            NodePtr right = insertAt(node->right, value, weight, added);
+            if (right->weight > node->weight) {
+                return make(right->value, right->weight,
+                            make(node->value, node->weight, node->left, right->left),
+                            right->right);
+            }
+            return make(node->value, node->weight, node->left, right);
+        }
+        return make(value, node->weight, node->left, node->right);
+    }
+    
+    // Copy of node's subtree without value; untouched when value is absent
+    static NodePtr eraseAt(const NodePtr& node, const T& value, bool& removed) {
+        if (!node) return node;
+        
+        Less less;
+        if (less(value, node->value)) {
+            NodePtr left = eraseAt(node->left, value, removed);
+            return removed ? make(node->value, node->weight, left, node->right) : node;
+        }
+        if (less(node->value, value)) {
+            NodePtr right = eraseAt(node->right, value, removed);
+            return removed ? make(node->value, node->weight, node->left, right) : node;
+        }
+        removed = true;
+        return join(node->left, node->right);
+    }
+    
+    // Merge two subtrees whose values are all ordered a before b
+    static NodePtr join(const NodePtr& a, const NodePtr& b) {
+        if (!a) return b;
+        if (!b) return a;
+        if (a->weight > b->weight) {
+            return make(a->value, a->weight, a->left, join(a->right, b));
+        }
+        return make(b->value, b->weight, join(a, b->left), b->right);
+    }
+    
+    template<typename F>
+    static void visit(const Node* node, F& f) {
+        if (!node) return;
+        visit(node->left.get(), f);
+        f(node->value);
+        visit(node->right.get(), f);
+    }
+    
+    // In-order walk from low while f returns true; returns false once f
+    // has asked to stop
+    template<typename F>
+    static bool visitFrom(const Node* node, const T& low, F& f) {
+        if (!node) return true;
+        if (Less()(node->value, low)) {
+            return visitFrom(node->right.get(), low, f);
+        }
+        return visitFrom(node->left.get(), low, f) && f(node->value) &&
+               visitFrom(node->right.get(), low, f);
+    }
+
+public:
+    PersistentSet() : count(0), seed(0x9e3779b9u) {}
+    
+    // Add value, replacing an equal one
+    void insert(const T& value) {
+        bool added = false;
+        root = insertAt(root, value, nextWeight(), added);
+        if (added) count++;
+    }
+    
+    // Remove the value equal to value, if any
+    void erase(const T& value) {
+        bool removed = false;
+        root = eraseAt(root, value, removed);
+        if (removed) count--;
+    }
+    
+    // Stored value equal to probe, or nullptr
+    const T* find(const T& probe) const {
+        Less less;
+        const Node* node = root.get();
+        while (node) {
+            if (less(probe, node->value)) {
+                node = node->left.get();
+            } else if (less(node->value, probe)) {
+                node = node->right.get();
+            } else {
+                return &node->value;
+            }
+        }
+        return nullptr;
+    }
+    
+    // Call f(value) for every value in order
+    template<typename F>
+    void forEach(F f) const {
+        visit(root.get(), f);
+    }
+    
+    // Call f(value) in order for values not before low until f returns false
+    template<typename F>
+    void forEachFrom(const T& low, F f) const {
+        visitFrom(root.get(), low, f);
+    }
+    
+    // Check if set is empty
+    bool empty() const {
+        return count == 0;
+    }
+    
+    // Get number of values
+    size_t size() const {
+        return count;
+    }
+    
+    // Drop this version's values; other copies keep theirs
+    void clear() {
+        root.reset();
+        count = 0;
+    }
+};
+
+#endif // PERSISTENT_SET_H
@@ -0,0 +1,37 @@
+#ifndef QUEUE_POLICY_H
+#define QUEUE_POLICY_H
+
+#include "PairingHeap.h"
+#include "RankPairingHeap.h"
+#include "IndexedMinHeap.h"
+#include "IndexedRadixHeap.h"
+
+// Queue backends the Scheduler is compiled with. Defaults are the pairing
+// heap and binary heaps; the Makefile's PENDING, HEAP_ARITY and TIME_QUEUE
+// options select the others (see bench/QueueMatrix.cpp for how they compare).
+
+#ifndef SCHEDULER_HEAP_ARITY
+#define SCHEDULER_HEAP_ARITY 2
+#endif
+
+// Pending flights in greedy order, with handles for re-keying and erase
+#ifdef SCHEDULER_RANK_PAIRING
+typedef RankPairingHeap PendingQueue;
+#else
+typedef PairingHeap PendingQueue;
+#endif
+
+// Runway pool, re-keyed in place as runways take flights
+template<typename T>
+using RunwayQueue = IndexedMinHeap<T, SCHEDULER_HEAP_ARITY>;
+
+// Timetable and start queue, popped in time order as the clock advances
+#ifdef SCHEDULER_RADIX_TIME_QUEUES
+template<typename T>
+using TimeQueue = IndexedRadixHeap<T>;
+#else
+template<typename T>
+using TimeQueue = IndexedMinHeap<T, SCHEDULER_HEAP_ARITY>;
+#endif
+
+#endif // QUEUE_POLICY_H
@@ -0,0 +1,47 @@
+#ifndef RADIX_SORT_H
+#define RADIX_SORT_H
+
+#include <cstdint>
+#include <vector>
+
+// Pack a signed key and a payload so that unsigned order of the result is
+// key order
+inline uint64_t radixItem(int key, int payload) {
+    return ((uint64_t)((uint32_t)key ^ 0x80000000u) << 32) | (uint32_t)payload;
+}
+
+// Payload of a packed item
+inline int radixPayload(uint64_t item) {
+    return (int)(uint32_t)item;
+}
+
+// LSD radix sort of packed items by their key half: three 11-bit passes,
+// skipping any pass where every key has the same digit. Stable; scratch
+// is resized as needed.
+inline void radixSortByKey(std::vector<uint64_t>& items, std::vector<uint64_t>& scratch) {
+    const int DIGIT_BITS = 11;
+    const int BUCKETS = 1 << DIGIT_BITS;
+    size_t n = items.size();
+    scratch.resize(n);
+    
+    for (int shift = 32; shift < 64; shift += DIGIT_BITS) {
+        size_t counts[BUCKETS] = {0};
+        for (size_t i = 0; i < n; i++) {
+            counts[(items[i] >> shift) & (BUCKETS - 1)]++;
+        }
+        if (n == 0 || counts[(items[0] >> shift) & (BUCKETS - 1)] == n) continue;
+        
+        size_t offset = 0;
+        for (int b = 0; b < BUCKETS; b++) {
+            size_t count = counts[b];
+            counts[b] = offset;
+            offset += count;
+        }
+        for (size_t i = 0; i < n; i++) {
+            scratch[counts[(items[i] >> shift) & (BUCKETS - 1)]++] = items[i];
+        }
+        items.swap(scratch);
+    }
+}
+
+#endif // RADIX_SORT_H
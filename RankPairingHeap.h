@@ -0,0 +1,333 @@
+#ifndef RANK_PAIRING_HEAP_H
+#define RANK_PAIRING_HEAP_H
+
+#include "Flight.h"
+#include <new>
+#include <utility>
+#include <vector>
+
+struct RankPairingNode {
+    int priority;
+    int negSubmitTime;
+    int negFlightID;
+    int slot;               // FlightTable slot of the queued flight
+    int rank;
+    RankPairingNode* left;  // First child
+    RankPairingNode* right; // Next sibling; for roots, the next root
+    RankPairingNode* parent;    // nullptr for roots
+    
+    RankPairingNode(const PlanKey& key, int s)
+        : priority(key.priority),
+          negSubmitTime(PlanKey::negated(key.submitTime)),
+          negFlightID(PlanKey::negated(key.flightID)),
+          slot(s), rank(0), left(nullptr), right(nullptr), parent(nullptr) {}
+    
+    bool operator>(const RankPairingNode& other) const {
+        if (priority != other.priority) return priority > other.priority;
+        if (negSubmitTime != other.negSubmitTime) return negSubmitTime > other.negSubmitTime;
+        return negFlightID > other.negFlightID;
+    }
+};
+
+// Rank-pairing heap (type 2) with the same interface and node arena as
+// PairingHeap. Half trees are kept in binary form: a node's left subtree
+// holds its descendants, its right pointer the next sibling. Roots form
+// a list; pop links equal-rank roots in one pass, and raising a key cuts
+// the node out and repairs ranks up the path it left.
+class RankPairingHeap {
+public:
+    typedef RankPairingNode Node;
+    typedef RankPairingNode* Handle;
+
+private:
+    Node* roots;            // Root list, chained through right
+    Node* best;             // Root that comes first
+    size_t count;
+    
+    // Node arena, as in PairingHeap
+    static const int BLOCK_SIZE = 1024;
+    std::vector<Node*> blocks;
+    size_t activeBlock;
+    int blockUsed;
+    Node* freeList;         // Chained through right
+    // Roots by rank during consolidation
+    std::vector<Node*> bucket;
+    
+    // Unconstructed node storage
+    Node* rawNode() {
+        Node* node;
+        if (freeList) {
+            node = freeList;
+            freeList = freeList->right;
+        } else {
+            if (activeBlock == blocks.size()) {
+                blocks.push_back(static_cast<Node*>(::operator new(BLOCK_SIZE * sizeof(Node))));
+            }
+            node = blocks[activeBlock] + blockUsed++;
+            if (blockUsed == BLOCK_SIZE) {
+                activeBlock++;
+                blockUsed = 0;
+            }
+        }
+        return node;
+    }
+    
+    void release(Node* node) {
+        node->right = freeList;
+        freeList = node;
+    }
+    
+    // Rank of a possibly missing child
+    static int rankOf(const Node* node) {
+        return node ? node->rank : -1;
+    }
+    
+    // Rank of a root: one more than its only (left) child's
+    static int rootRank(const Node* node) {
+        return rankOf(node->left) + 1;
+    }
+    
+    // Add a detached half tree to the root list
+    void addRoot(Node* node) {
+        node->parent = nullptr;
+        node->right = roots;
+        roots = node;
+        if (!best || *node > *best) best = node;
+    }
+    
+    // Link two roots of equal rank; the loser becomes the winner's first
+    // child and takes the winner's old subtree as its right subtree
+    Node* link(Node* a, Node* b) {
+        if (*b > *a) std::swap(a, b);
+        b->right = a->left;
+        if (b->right) b->right->parent = b;
+        a->left = b;
+        b->parent = a;
+        a->rank++;
+        return a;
+    }
+    
+    // Detach a non-root node with its left subtree; its right subtree
+    // takes its place. Ranks on the path it left are repaired (type-2
+    // rule) until one does not drop.
+    void cut(Node* node) {
+        Node* parent = node->parent;
+        Node* replacement = node->right;
+        if (parent->left == node) {
+            parent->left = replacement;
+        } else {
+            parent->right = replacement;
+        }
+        if (replacement) replacement->parent = parent;
+        node->right = nullptr;
+        node->parent = nullptr;
+        node->rank = rootRank(node);
+        
+        for (Node* u = parent; u; u = u->parent) {
+            int rank;
+            if (!u->parent) {
+                rank = rootRank(u);
+            } else {
+                int r1 = rankOf(u->left);
+                int r2 = rankOf(u->right);
+                int high = r1 > r2 ? r1 : r2;
+                rank = (r1 - r2 > 1 || r2 - r1 > 1) ? high : high + 1;
+            }
+            if (rank >= u->rank) break;
+            u->rank = rank;
+        }
+    }
+    
+    // Take a root out: its left spine becomes new roots, then roots of
+    // equal rank are linked in one pass and the first root is found again
+    void removeRoot(Node* node) {
+        Node* list = nullptr;
+        for (Node* r = roots; r; ) {
+            Node* next = r->right;
+            if (r != node) {
+                r->right = list;
+                list = r;
+            }
+            r = next;
+        }
+        for (Node* child = node->left; child; ) {
+            Node* next = child->right;
+            child->right = list;
+            child->parent = nullptr;
+            child->rank = rootRank(child);
+            list = child;
+            child = next;
+        }
+        
+        roots = nullptr;
+        best = nullptr;
+        while (list) {
+            Node* r = list;
+            list = list->right;
+            if ((int)bucket.size() <= r->rank) bucket.resize(r->rank + 1, nullptr);
+            Node*& slot = bucket[r->rank];
+            if (!slot) {
+                slot = r;
+            } else {
+                Node* other = slot;
+                slot = nullptr;
+                addRoot(link(other, r));
+            }
+        }
+        for (Node*& r : bucket) {
+            if (r) {
+                addRoot(r);
+                r = nullptr;
+            }
+        }
+        release(node);
+        count--;
+    }
+    
+    // Unlinked copy of a node's key, slot and rank
+    Node* copyNode(const Node* source) {
+        Node* node = new (rawNode()) Node(*source);
+        node->left = nullptr;
+        node->right = nullptr;
+        node->parent = nullptr;
+        return node;
+    }
+    
+    // Copy other's roots and half trees into this (empty) heap, keeping
+    // their shape and ranks
+    void copyTrees(const RankPairingHeap& other) {
+        count = other.count;
+        std::vector<std::pair<const Node*, Node*>> stack;
+        Node* lastRoot = nullptr;
+        for (const Node* r = other.roots; r; r = r->right) {
+            Node* copy = copyNode(r);
+            if (lastRoot) {
+                lastRoot->right = copy;
+            } else {
+                roots = copy;
+            }
+            lastRoot = copy;
+            if (r == other.best) best = copy;
+            
+            // Roots have no right subtree, so only left links are followed
+            // from the root itself
+            stack.push_back(std::make_pair(r, copy));
+            while (!stack.empty()) {
+                const Node* source = stack.back().first;
+                Node* target = stack.back().second;
+                stack.pop_back();
+                if (source->left) {
+                    target->left = copyNode(source->left);
+                    target->left->parent = target;
+                    stack.push_back(std::make_pair(source->left, target->left));
+                }
+                if (source->parent && source->right) {
+                    target->right = copyNode(source->right);
+                    target->right->parent = target;
+                    stack.push_back(std::make_pair(source->right, target->right));
+                }
+            }
+        }
+    }
+
+public:
+    RankPairingHeap()
+        : roots(nullptr), best(nullptr), count(0), activeBlock(0), blockUsed(0),
+          freeList(nullptr) {}
+    
+    // A copy has the same trees in its own arena; handles do not carry over
+    RankPairingHeap(const RankPairingHeap& other)
+        : roots(nullptr), best(nullptr), count(0), activeBlock(0), blockUsed(0),
+          freeList(nullptr) {
+        copyTrees(other);
+    }
+    
+    // Assignment rewinds this heap's arena and copies into its blocks
+    RankPairingHeap& operator=(const RankPairingHeap& other) {
+        if (this != &other) {
+            clear();
+            copyTrees(other);
+        }
+        return *this;
+    }
+    
+    ~RankPairingHeap() {
+        for (Node* block : blocks) {
+            ::operator delete(block);
+        }
+    }
+    
+    // Drop all nodes by rewinding the arena
+    void clear() {
+        roots = nullptr;
+        best = nullptr;
+        count = 0;
+        activeBlock = 0;
+        blockUsed = 0;
+        freeList = nullptr;
+    }
+    
+    // Insert flight slot under its greedy key as a new rank-0 root
+    Handle push(const PlanKey& key, int slot) {
+        Node* node = new (rawNode()) Node(key, slot);
+        addRoot(node);
+        count++;
+        return node;
+    }
+    
+    // Slot of the first flight in greedy order (-1 if empty)
+    int top() {
+        return best ? best->slot : -1;
+    }
+    
+    void pop() {
+        if (best) removeRoot(best);
+    }
+    
+    // Raise a node's priority in place
+    void increaseKey(Handle node, int newPriority) {
+        node->priority = newPriority;
+        if (node->parent) {
+            cut(node);
+            node->right = roots;
+            roots = node;
+        }
+        if (*node > *best) best = node;
+    }
+    
+    // Remove an arbitrary node
+    void erase(Handle node) {
+        if (node->parent) {
+            cut(node);
+            node->right = roots;
+            roots = node;
+        }
+        removeRoot(node);
+    }
+    
+    // Call visit(node) for every node in the heap
+    template <class Visit>
+    void visitNodes(Visit visit) {
+        std::vector<Node*> stack;
+        for (Node* r = roots; r; r = r->right) {
+            stack.push_back(r);
+            while (!stack.empty()) {
+                Node* node = stack.back();
+                stack.pop_back();
+                visit(node);
+                if (node->left) stack.push_back(node->left);
+                if (node->parent && node->right) stack.push_back(node->right);
+            }
+        }
+    }
+    
+    bool empty() const {
+        return count == 0;
+    }
+    
+    size_t size() const {
+        return count;
+    }
+};
+
+#endif // RANK_PAIRING_HEAP_H
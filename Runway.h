@@ -1,80 +1,93 @@
 #ifndef RUNWAY_H
 #define RUNWAY_H
 
-#include <iostream>
-
 /**
  * Runway structure for tracking runway availability
- * Used in the Runway Pool (MinHeap)
+ * Used in the Runway Pool (RunwayQueue)
  * Sorted by: (nextFreeTime, runwayID)
  */
-struct RunwayInfo {
-    int runwayID;        
-    int nextFreeTime;    
+struct Runway {
+    int nextFreeTime;
+    int runwayID;
     
     // Constructor
-    RunwayInfo(int id = 0, int freeTime = 0) 
-        : runwayID(id), nextFreeTime(freeTime) {}
+    Runway(int id, int time) : nextFreeTime(time), runwayID(id) {}
     
-    // Comparison operator for min-heap
+    // Comparison operators for min-heap
     // Primary: earlier nextFreeTime
     // Tie-breaker: smaller runwayID
-    bool operator<(const RunwayInfo& other) const {
-        if (nextFreeTime != other.nextFreeTime) {
-            return nextFreeTime < other.nextFreeTime;
-        }
-        return runwayID < other.runwayID;
-    }
-    
-    bool operator>(const RunwayInfo& other) const {
-        if (nextFreeTime != other.nextFreeTime) {
+    bool operator>(const Runway& other) const {
+        if (nextFreeTime != other.nextFreeTime)
             return nextFreeTime > other.nextFreeTime;
-        }
         return runwayID > other.runwayID;
     }
     
-    // friend std::ostream& operator<<(std::ostream& os, const RunwayInfo& r) {
-    //     os << "[R" << r.runwayID << "@" << r.nextFreeTime << "]";
-    //     return os;
-    // }
+    bool operator<(const Runway& other) const {
+        if (nextFreeTime != other.nextFreeTime)
+            return nextFreeTime < other.nextFreeTime;
+        return runwayID < other.runwayID;
+    }
 };
 
 /**
  * Timetable entry for tracking flight completions
- * Used in the Timetable (MinHeap)
+ * Used in the Timetable (TimeQueue)
  * Sorted by: (ETA, flightID)
  */
 struct TimetableEntry {
-    int ETA;            
-    int flightID;        
-    int runwayID;      
+    int ETA;
+    int flightID;
+    int runwayID;
     
     // Constructor
-    TimetableEntry(int eta = 0, int fid = 0, int rid = 0)
+    TimetableEntry(int eta, int fid, int rid) 
         : ETA(eta), flightID(fid), runwayID(rid) {}
     
-    // Comparison operator for min-heap
+    // Comparison operators for min-heap
     // Primary: earlier ETA
     // Tie-breaker: smaller flightID
+    bool operator>(const TimetableEntry& other) const {
+        if (ETA != other.ETA)
+            return ETA > other.ETA;
+        return flightID > other.flightID;
+    }
+    
     bool operator<(const TimetableEntry& other) const {
-        if (ETA != other.ETA) {
+        if (ETA != other.ETA)
             return ETA < other.ETA;
-        }
         return flightID < other.flightID;
     }
+};
+
+// Radix key: completions are ordered by ETA first
+inline int queueTime(const TimetableEntry& entry) { return entry.ETA; }
+
+/**
+ * Departure entry for scheduled flights
+ * Used in the Start Queue (TimeQueue)
+ * Sorted by: (startTime, flightID)
+ */
+struct StartEntry {
+    int startTime;
+    int flightID;
     
-    bool operator>(const TimetableEntry& other) const {
-        if (ETA != other.ETA) {
-            return ETA > other.ETA;
-        }
+    // Constructor
+    StartEntry(int st, int fid) : startTime(st), flightID(fid) {}
+    
+    bool operator>(const StartEntry& other) const {
+        if (startTime != other.startTime)
+            return startTime > other.startTime;
         return flightID > other.flightID;
-    } 
+    }
     
-    // // For debugging
-    // friend std::ostream& operator<<(std::ostream& os, const TimetableEntry& t) {
-    //     os << "[F" << t.flightID << "@ETA" << t.ETA << "]";
-    //     return os;
-    // }
+    bool operator<(const StartEntry& other) const {
+        if (startTime != other.startTime)
+            return startTime < other.startTime;
+        return flightID < other.flightID;
+    }
 };
 
-#endif 
\ No newline at end of file
+// Radix key: departures are ordered by start time first
+inline int queueTime(const StartEntry& entry) { return entry.startTime; }
+
+#endif // RUNWAY_H
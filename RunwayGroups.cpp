@@ -0,0 +1,469 @@
+#include "RunwayGroups.h"
+#include "Snapshot.h"
+#include <algorithm>
+#include <climits>
+
+RunwayGroups::RunwayGroups(int threads)
+    : pool(threads), delays(pool), branchOpen(false), changes(0) {}
+
+// Scheduler for groupID, created without runways on first use
+Scheduler& RunwayGroups::group(int groupID) {
+    auto it = groups.find(groupID);
+    if (it != groups.end()) {
+        return *it->second;
+    }
+    
+    groups[groupID].reset(new Scheduler());
+    listMembers();
+    return *groups[groupID];
+}
+
+// Rebuild members after groups changed
+void RunwayGroups::listMembers() {
+    members.clear();
+    for (auto& entry : groups) {
+        members.push_back(entry.second.get());
+    }
+}
+
+// Group holding flightID, or nullptr
+Scheduler* RunwayGroups::owner(int flightID) {
+    for (Scheduler* member : members) {
+        if (member->hasFlight(flightID)) {
+            return member;
+        }
+    }
+    return nullptr;
+}
+
+// Advance every group in parallel, then print the merged events
+void RunwayGroups::advanceAll(int time, OutputSink& output) {
+    pool.run(members.size(), [this, time](size_t i) { members[i]->advanceSilently(time); });
+    reportMerged(output);
+}
+
+// Landings sorted by (ETA, flightID), then one Updated ETAs line by flightID
+void RunwayGroups::reportMerged(OutputSink& output) {
+    landed.clear();
+    updated.clear();
+    for (Scheduler* member : members) {
+        member->takeEvents(landed, updated);
+    }
+    
+    if (members.size() > 1) {
+        std::sort(landed.begin(), landed.end());
+    }
+    Scheduler::printLanded(landed, output);
+    Scheduler::printUpdatedETAs(updated, output);
+}
+
+// Initialize one group; other groups are left as they are
+void RunwayGroups::initialize(int runwayCount, int groupID, OutputSink& output) {
+    group(groupID).initialize(runwayCount, output);
+}
+
+// Add a flight to a group; IDs must be unique across all groups
+void RunwayGroups::submitFlight(int flightID, int airlineID, int submitTime, int priority,
+                                int duration, int groupID, OutputSink& output) {
+    Scheduler& target = group(groupID);
+    advanceAll(submitTime, output);
+    
+    if (owner(flightID)) {
+        output << "Duplicate FlightID";
+        output.endl();
+        return;
+    }
+    
+    target.admitFlight(Flight(flightID, airlineID, submitTime, priority, duration), output);
+}
+
+// Cancel a flight in whichever group holds it
+void RunwayGroups::cancelFlight(int flightID, int time, OutputSink& output) {
+    advanceAll(time, output);
+    
+    Scheduler* holder = owner(flightID);
+    if (!holder) {
+        output << "Flight " << flightID << " does not exist";
+        output.endl();
+        return;
+    }
+    holder->withdrawFlight(flightID, output);
+}
+
+// Reprioritize a flight in whichever group holds it
+void RunwayGroups::reprioritize(int flightID, int time, int newPriority,
+                                OutputSink& output) {
+    advanceAll(time, output);
+    
+    Scheduler* holder = owner(flightID);
+    if (!holder) {
+        output << "Flight " << flightID << " not found";
+        output.endl();
+        return;
+    }
+    holder->changePriority(flightID, newPriority, output);
+}
+
+// Add runways to one group
+void RunwayGroups::addRunways(int count, int time, int groupID, OutputSink& output) {
+    Scheduler& target = group(groupID);
+    advanceAll(time, output);
+    target.openRunways(count, output);
+}
+
+// Ground the airline range everywhere; groups replan in parallel
+void RunwayGroups::groundHold(int airlineLow, int airlineHigh, int time,
+                              OutputSink& output) {
+    advanceAll(time, output);
+    
+    if (airlineHigh < airlineLow) {
+        output << "Invalid input. Please provide a valid airline range.";
+        output.endl();
+        return;
+    }
+    
+    pool.run(members.size(), [this, airlineLow, airlineHigh](size_t i) {
+        members[i]->groundAirlines(airlineLow, airlineHigh);
+        members[i]->replanSilently();
+    });
+    
+    output << "Flights of the airlines in the range [" << airlineLow << ", "
+           << airlineHigh << "] have been grounded";
+    output.endl();
+    
+    reportMerged(output);
+}
+
+// Print active flights of all groups sorted by ID
+void RunwayGroups::printActive(OutputSink& output) {
+    if (members.size() == 1) {
+        members[0]->printActive(output);
+        return;
+    }
+    
+    std::vector<Flight> active;
+    for (Scheduler* member : members) {
+        member->collectActive(active);
+    }
+    
+    if (active.empty()) {
+        output << "No active flights";
+        output.endl();
+        return;
+    }
+    
+    std::sort(active.begin(), active.end(),
+              [](const Flight& a, const Flight& b) { return a.flightID < b.flightID; });
+    for (const Flight& flight : active) {
+        Scheduler::printActiveLine(flight, output);
+    }
+}
+
+// Print scheduled flights of all groups in time range, sorted by ETA
+void RunwayGroups::printSchedule(int t1, int t2, OutputSink& output) {
+    std::vector<std::pair<int, int>> scheduled;
+    for (Scheduler* member : members) {
+        member->collectScheduled(t1, t2, scheduled);
+    }
+    
+    if (members.size() > 1) {
+        std::sort(scheduled.begin(), scheduled.end());
+    }
+    Scheduler::printScheduleLines(scheduled, output);
+}
+
+// Advance every group
+void RunwayGroups::tick(int time, OutputSink& output) {
+    advanceAll(time, output);
+}
+
+// Header, then each group's ID and state in groupID order
+bool RunwayGroups::saveSnapshot(const std::string& path, uint32_t generation) {
+    SnapshotWriter writer;
+    writer.putWord(SNAPSHOT_MAGIC);
+    writer.putWord(SNAPSHOT_VERSION);
+    writer.putWord((uint32_t)groups.size());
+    writer.putWord(generation);
+    for (auto& entry : groups) {
+        writer.putInt(entry.first);
+        entry.second->saveState(writer);
+    }
+    return writer.writeFile(path);
+}
+
+// Map the snapshot and load it into fresh schedulers, swapping them in
+// only once the whole file has been read
+bool RunwayGroups::loadSnapshot(const std::string& path, uint32_t& generation) {
+    MappedFile file;
+    if (!file.open(path)) return false;
+    
+    SnapshotReader reader(file.begin(), file.end());
+    uint32_t magic, version, groupCount;
+    if (!reader.getWord(magic) || !reader.getWord(version) || 
+        !reader.getWord(groupCount) || !reader.getWord(generation) || 
+        magic != SNAPSHOT_MAGIC || version != SNAPSHOT_VERSION) {
+        return false;
+    }
+    
+    std::map<int, std::unique_ptr<Scheduler>> loaded;
+    for (uint32_t g = 0; g < groupCount; g++) {
+        int groupID;
+        std::unique_ptr<Scheduler> scheduler(new Scheduler());
+        if (!reader.getInt(groupID) || loaded.count(groupID) || 
+            !scheduler->loadState(reader)) {
+            return false;
+        }
+        loaded[groupID] = std::move(scheduler);
+    }
+    if (!reader.atEnd()) return false;
+    
+    groups.swap(loaded);
+    listMembers();
+    changes++;
+    return true;
+}
+
+// Save every group's state to a snapshot file
+void RunwayGroups::snapshot(const std::string& path, OutputSink& output) {
+    if (!saveSnapshot(path, 0)) {
+        output << "Cannot write snapshot " << path;
+        output.endl();
+        return;
+    }
+    output << "Snapshot saved to " << path;
+    output.endl();
+}
+
+// Replace all groups with a snapshot file's state
+void RunwayGroups::restore(const std::string& path, OutputSink& output) {
+    uint32_t generation;
+    if (!loadSnapshot(path, generation)) {
+        output << "Cannot restore snapshot " << path;
+        output.endl();
+        return;
+    }
+    output << "State restored from " << path;
+    output.endl();
+}
+
+// Fork every group on the pool and park the copies
+void RunwayGroups::simulate(OutputSink& output) {
+    if (branchOpen) {
+        output << "Simulation already in progress";
+        output.endl();
+        return;
+    }
+    
+    std::vector<std::unique_ptr<Scheduler>> copies(members.size());
+    pool.run(members.size(), [this, &copies](size_t i) { copies[i] = members[i]->fork(); });
+    size_t i = 0;
+    for (auto& entry : groups) {
+        parked[entry.first] = std::move(copies[i++]);
+    }
+    branchOpen = true;
+    output << "Simulation started";
+    output.endl();
+}
+
+// Drop the parked copies; the live groups already hold the branch
+void RunwayGroups::commit(OutputSink& output) {
+    if (!branchOpen) {
+        output << "No simulation in progress";
+        output.endl();
+        return;
+    }
+    parked.clear();
+    branchOpen = false;
+    output << "Simulation committed";
+    output.endl();
+}
+
+// Swap the parked copies back in
+void RunwayGroups::discard(OutputSink& output) {
+    if (!branchOpen) {
+        output << "No simulation in progress";
+        output.endl();
+        return;
+    }
+    groups.swap(parked);
+    parked.clear();
+    listMembers();
+    branchOpen = false;
+    output << "Simulation discarded";
+    output.endl();
+}
+
+// Print instrumentation counters per group
+void RunwayGroups::printStats(OutputSink& output) {
+    for (auto& entry : groups) {
+        if (groups.size() > 1) {
+            output << "group " << entry.first;
+            output.endl();
+        }
+        entry.second->printStats(output);
+    }
+}
+
+// Simulate each group on its own; groups share no runways, so their
+// results are independent and only need merging into one ETA order
+void RunwayGroups::delayEstimate(int trials, int sigmaPercent, int seed, OutputSink& output) {
+    if (trials <= 0 || sigmaPercent < 0) {
+        output << "Invalid input. Please provide a positive trial count and sigma.";
+        output.endl();
+        return;
+    }
+    
+    std::vector<EtaPercentiles> results;
+    std::vector<EtaPercentiles> groupResults;
+    for (Scheduler* member : members) {
+        delays.run(*member, trials, sigmaPercent / 100.0, (uint64_t)(uint32_t)seed);
+        delays.percentiles(groupResults);
+        results.insert(results.end(), groupResults.begin(), groupResults.end());
+    }
+    if (members.size() > 1) {
+        std::sort(results.begin(), results.end(),
+                  [](const EtaPercentiles& a, const EtaPercentiles& b) {
+                      if (a.plannedETA != b.plannedETA) return a.plannedETA < b.plannedETA;
+                      return a.flightID < b.flightID;
+                  });
+    }
+    DelaySimulation::print(results, output);
+}
+
+// Group named by a command's optional group argument (0 when absent)
+static int commandGroup(const Command& command) {
+    switch (command.type) {
+    case CMD_INITIALIZE:
+        return command.argCount >= 2 ? command.args[1] : 0;
+    case CMD_SUBMIT_FLIGHT:
+        return command.argCount >= 6 ? command.args[5] : 0;
+    case CMD_ADD_RUNWAYS:
+        return command.argCount >= 3 ? command.args[2] : 0;
+    default:
+        return 0;
+    }
+}
+
+// Take every group's current view sets into a new view. Each group only
+// revisits the flights its commands touched, and the sets share all other
+// nodes with the previous view, so publishing costs no full copy. Skipped
+// when no command has run since the last view.
+void RunwayGroups::publishView() {
+    if (published && published->version == changes) return;
+    
+    std::shared_ptr<ScheduleView> next = std::make_shared<ScheduleView>();
+    next->version = changes;
+    for (Scheduler* member : members) {
+        member->refreshView();
+        next->active.push_back(member->activeView());
+        next->scheduled.push_back(member->scheduledView());
+    }
+    std::atomic_store(&published, std::shared_ptr<const ScheduleView>(next));
+}
+
+// Run one decoded input command; a lone group runs it directly
+void RunwayGroups::execute(const Command& command, OutputSink& output) {
+    // Anything but a query may change state (a spare count only costs a
+    // view rebuild)
+    if (!ScheduleView::answers(command)) {
+        changes++;
+    }
+    
+    if (command.type == CMD_SNAPSHOT) {
+        snapshot(std::string(command.text, command.textLength), output);
+        return;
+    }
+    if (command.type == CMD_RESTORE) {
+        restore(std::string(command.text, command.textLength), output);
+        return;
+    }
+    if (command.type == CMD_SIMULATE) {
+        simulate(output);
+        return;
+    }
+    if (command.type == CMD_COMMIT) {
+        commit(output);
+        return;
+    }
+    if (command.type == CMD_DISCARD) {
+        discard(output);
+        return;
+    }
+    if (command.type == CMD_DELAY_ESTIMATE) {
+        if (command.argCount >= 2) {
+            delayEstimate(command.args[0], command.args[1],
+                          command.argCount >= 3 ? command.args[2] : 1, output);
+        }
+        return;
+    }
+    
+    if (groups.size() == 1 && commandGroup(command) == groups.begin()->first) {
+        members[0]->execute(command, output);
+        return;
+    }
+    
+    const int* args = command.args;
+    int argCount = command.argCount;
+    
+    switch (command.type) {
+    case CMD_INITIALIZE:
+        if (argCount >= 1) {
+            initialize(args[0], commandGroup(command), output);
+        }
+        break;
+    case CMD_SUBMIT_FLIGHT:
+        if (argCount >= 5) {
+            submitFlight(args[0], args[1], args[2], args[3], args[4],
+                         commandGroup(command), output);
+        }
+        break;
+    case CMD_CANCEL_FLIGHT:
+        if (argCount >= 2) {
+            cancelFlight(args[0], args[1], output);
+        }
+        break;
+    case CMD_REPRIORITIZE:
+        if (argCount >= 3) {
+            reprioritize(args[0], args[1], args[2], output);
+        }
+        break;
+    case CMD_ADD_RUNWAYS:
+        if (argCount >= 2) {
+            addRunways(args[0], args[1], commandGroup(command), output);
+        }
+        break;
+    case CMD_GROUND_HOLD:
+        if (argCount >= 3) {
+            groundHold(args[0], args[1], args[2], output);
+        }
+        break;
+    case CMD_PRINT_ACTIVE:
+        printActive(output);
+        break;
+    case CMD_PRINT_SCHEDULE:
+        if (argCount >= 2) {
+            printSchedule(args[0], args[1], output);
+        }
+        break;
+    case CMD_TICK:
+        if (argCount >= 1) {
+            tick(args[0], output);
+        }
+        break;
+    case CMD_QUIT:
+        output << "Program Terminated!!";
+        output.endl();
+        break;
+    case CMD_STATS:
+        printStats(output);
+        break;
+    case CMD_SNAPSHOT:
+    case CMD_RESTORE:
+    case CMD_SIMULATE:
+    case CMD_COMMIT:
+    case CMD_DISCARD:
+    case CMD_DELAY_ESTIMATE:
+    case CMD_UNKNOWN:
+        break;
+    }
+}
@@ -0,0 +1,120 @@
+#ifndef RUNWAY_GROUPS_H
+#define RUNWAY_GROUPS_H
+
+#include "DelaySimulation.h"
+#include "Scheduler.h"
+#include "ScheduleView.h"
+#include "ThreadPool.h"
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Independent runway groups (airfields) driven as one scheduler. Each group
+// is its own Scheduler with its own runways and flights; flight IDs are
+// unique across groups. Every timed command first advances all groups on
+// the thread pool, then prints their landings and ETA changes merged in
+// the order a single scheduler would use. With one group the output is
+// exactly that of a plain Scheduler.
+//
+// simulate() opens a what-if branch: every group is forked and the copies
+// are parked while later commands change the live groups; discard() swaps
+// the parked copies back and commit() drops them.
+//
+// publishView() swaps in an immutable ScheduleView of the current state
+// with an atomic shared_ptr store; reader threads take it with view() and
+// answer queries from it without touching the schedulers. Views are built
+// from each group's persistent view sets, so publishing costs only the
+// flights changed since the last view.
+class RunwayGroups {
+private:
+    std::map<int, std::unique_ptr<Scheduler>> groups;
+    // Group schedulers in groupID order, indexed by pool tasks
+    std::vector<Scheduler*> members;
+    ThreadPool pool;
+    // DelayEstimate's simulation; its replicas are reused by every group
+    // and command
+    DelaySimulation delays;
+    
+    // Merge buffers
+    std::vector<TimetableEntry> landed;
+    std::vector<std::pair<int, int>> updated;
+    
+    // Pre-branch state while a what-if branch is open
+    std::map<int, std::unique_ptr<Scheduler>> parked;
+    bool branchOpen;
+    
+    // Latest published view; written only through std::atomic_store
+    std::shared_ptr<const ScheduleView> published;
+    // Commands run that may have changed state
+    uint64_t changes;
+    
+    // Scheduler for groupID, created without runways on first use
+    Scheduler& group(int groupID);
+    // Rebuild members after groups changed
+    void listMembers();
+    // Group holding flightID, or nullptr
+    Scheduler* owner(int flightID);
+    // Advance every group to time and print the merged events
+    void advanceAll(int time, OutputSink& output);
+    // Print landings and ETA changes taken from every group
+    void reportMerged(OutputSink& output);
+
+public:
+    explicit RunwayGroups(int threads);
+    
+    void initialize(int runwayCount, int groupID, OutputSink& output);
+    
+    void submitFlight(int flightID, int airlineID, int submitTime, int priority,
+                      int duration, int groupID, OutputSink& output);
+    
+    void cancelFlight(int flightID, int time, OutputSink& output);
+    
+    void reprioritize(int flightID, int time, int newPriority, OutputSink& output);
+    
+    void addRunways(int count, int time, int groupID, OutputSink& output);
+    // Ground flights for airline range in every group
+    void groundHold(int airlineLow, int airlineHigh, int time, OutputSink& output);
+    // Print active flights of all groups sorted by ID
+    void printActive(OutputSink& output);
+    // Print scheduled flights of all groups in time range
+    void printSchedule(int t1, int t2, OutputSink& output);
+    // Advance every group
+    void tick(int time, OutputSink& output);
+    // Write every group's state to a snapshot file tagged with generation
+    bool saveSnapshot(const std::string& path, uint32_t generation);
+    // Replace all groups with a snapshot file's state and report its
+    // generation; on failure the current state is kept
+    bool loadSnapshot(const std::string& path, uint32_t& generation);
+    // Save every group's state to a snapshot file
+    void snapshot(const std::string& path, OutputSink& output);
+    // Replace all groups with the state in a snapshot file; on failure the
+    // current state is kept
+    void restore(const std::string& path, OutputSink& output);
+    // Print instrumentation counters per group
+    void printStats(OutputSink& output);
+    // Open a what-if branch of the current state
+    void simulate(OutputSink& output);
+    // Keep the branch's state and close it
+    void commit(OutputSink& output);
+    // Return to the state from before the branch
+    void discard(OutputSink& output);
+    // Print per-flight ETA percentiles over trials of a Monte Carlo delay
+    // simulation (DelaySimulation) of every group, in planned ETA order.
+    // Durations are scaled by log-normal factors with sigma sigmaPercent / 100.
+    void delayEstimate(int trials, int sigmaPercent, int seed, OutputSink& output);
+    // Whether a what-if branch is open; its commands are not journaled
+    bool simulating() const { return branchOpen; }
+    // Publish a view of the current state unless the latest one is current.
+    // Runs on the thread that runs commands.
+    void publishView();
+    // Latest published view (nullptr before the first); safe from any thread
+    std::shared_ptr<const ScheduleView> view() const {
+        return std::atomic_load(&published);
+    }
+    // Run one decoded input command; the optional group argument follows
+    // the usual ones on Initialize, AddRunways and SubmitFlight
+    void execute(const Command& command, OutputSink& output);
+};
+
+#endif // RUNWAY_GROUPS_H
@@ -0,0 +1,96 @@
+#ifndef SCHEDULE_VIEW_H
+#define SCHEDULE_VIEW_H
+
+#include "Scheduler.h"
+#include "CommandReader.h"
+#include "RadixSort.h"
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <vector>
+
+// Immutable snapshot of what PrintActive and PrintSchedule read, published
+// by RunwayGroups::publishView. Neither query moves time, so a view answers
+// them exactly as the scheduler would have between the same two commands.
+// Views are shared read-only: any number of threads may query one while
+// the writer keeps changing the scheduler.
+struct ScheduleView {
+    // Number of state-changing commands the view reflects
+    uint64_t version;
+    // Per runway group, in groupID order: active flights by flightID, and
+    // (ETA, flightID) of flights not yet started. The sets share unchanged
+    // nodes with the scheduler's own and with earlier views.
+    std::vector<ActiveSet> active;
+    std::vector<ScheduledSet> scheduled;
+    
+    ScheduleView() : version(0) {}
+    
+    // Same output as Scheduler::printActive
+    void printActive(OutputSink& output) const {
+        size_t total = 0;
+        for (const ActiveSet& group : active) {
+            total += group.size();
+        }
+        if (total == 0) {
+            output << "No active flights";
+            output.endl();
+            return;
+        }
+        
+        // One group is already in flightID order
+        if (active.size() == 1) {
+            active[0].forEach([&output](const Flight& flight) {
+                Scheduler::printActiveLine(flight, output);
+            });
+            return;
+        }
+        
+        std::vector<Flight> flights;
+        flights.reserve(total);
+        for (const ActiveSet& group : active) {
+            group.forEach([&flights](const Flight& flight) { flights.push_back(flight); });
+        }
+        std::vector<uint64_t> order(flights.size());
+        std::vector<uint64_t> scratch;
+        for (size_t i = 0; i < flights.size(); i++) {
+            order[i] = radixItem(flights[i].flightID, (int)i);
+        }
+        radixSortByKey(order, scratch);
+        for (uint64_t item : order) {
+            Scheduler::printActiveLine(flights[radixPayload(item)], output);
+        }
+    }
+    
+    // Same output as Scheduler::printSchedule
+    void printSchedule(int t1, int t2, OutputSink& output) const {
+        std::vector<std::pair<int, int>> range;
+        for (const ScheduledSet& group : scheduled) {
+            group.forEachFrom(std::make_pair(t1, INT_MIN),
+                              [&range, t2](const std::pair<int, int>& entry) {
+                                  if (entry.first > t2) return false;
+                                  range.push_back(entry);
+                                  return true;
+                              });
+        }
+        if (scheduled.size() > 1) {
+            std::sort(range.begin(), range.end());
+        }
+        Scheduler::printScheduleLines(range, output);
+    }
+    
+    // Answer a query command; other commands print nothing
+    void execute(const Command& command, OutputSink& output) const {
+        if (command.type == CMD_PRINT_ACTIVE) {
+            printActive(output);
+        } else if (command.type == CMD_PRINT_SCHEDULE && command.argCount >= 2) {
+            printSchedule(command.args[0], command.args[1], output);
+        }
+    }
+    
+    // Commands a view can answer
+    static bool answers(const Command& command) {
+        return command.type == CMD_PRINT_ACTIVE || command.type == CMD_PRINT_SCHEDULE;
+    }
+};
+
+#endif // SCHEDULE_VIEW_H
@@ -1,28 +1,52 @@
 #include "Scheduler.h"
+#include "CommandReader.h"
+#include "RadixSort.h"
+#include "SchedulerStats.h"
+#include "Snapshot.h"
 #include <algorithm>
-#include <sstream>
+#include <climits>
 
-Scheduler::Scheduler() : currentTime(0), nextRunwayID(1) {}
+Scheduler::Scheduler() 
+    : currentTime(0), nextRunwayID(1), 
+      planValid(true), planDirty(false), replanAll(false), startedUnpromoted(false),
+      viewTracked(false) {}
 
-// Process flights that have completed their scheduling
-void Scheduler::settleCompletions(int time, std::vector<std::string>& output) {
-    std::vector<TimetableEntry> completed;
+// Process flights that have completed their scheduling; landings are
+// kept in landedFlights until reported
+void Scheduler::settleCompletions(int time) {
+    STATS_TIMER(stats.settle);
+    size_t first = landedFlights.size();
     
     while (!timetable.empty() && timetable.top().ETA <= time) {
-        completed.push_back(timetable.top());
+        landedFlights.push_back(timetable.top());
         timetable.pop();
     }
     
-    std::sort(completed.begin(), completed.end());
+    std::sort(landedFlights.begin() + first, landedFlights.end());
+    STATS_ADD(flightsLanded, landedFlights.size() - first);
     
-    for (const auto& entry : completed) {
-        output.push_back("Flight " + std::to_string(entry.flightID) + 
-                        " has landed at time " + std::to_string(entry.ETA));
-        
-        auto it = activeFlights.find(entry.flightID);
-        if (it != activeFlights.end()) {
-            int airlineID = it->second.airlineID;
-            activeFlights.erase(it);
+    for (size_t i = first; i < landedFlights.size(); i++) {
+        const TimetableEntry& entry = landedFlights[i];
+        int slot = flights.find(entry.flightID);
+        if (slot != -1) {
+            int airlineID = flights.airlineIDs[slot];
+            
+            // Runway goes idle once its last in-progress flight lands
+            int runwayID = flights.runwayIDs[slot];
+            if (runwayID > 0 && runwayID < (int)runwayBusyUntil.size() &&
+                runwayBusyUntil[runwayID] <= time) {
+                runwayBusyUntil[runwayID] = -1;
+            }
+            
+            // Flights can land before they were ever promoted
+            if (flights.states[slot] == SCHEDULED) {
+                etaIndex.erase(std::make_pair(entry.ETA, entry.flightID));
+                startQueue.erase(entry.flightID);
+                dropFromPlan(runwayID, entry.flightID);
+            }
+            unsatisfiedFlights.erase(entry.flightID);
+            
+            eraseFlight(slot);
             
             auto ait = airlineIndex.find(airlineID);
             if (ait != airlineIndex.end()) {
@@ -37,173 +61,347 @@ void Scheduler::settleCompletions(int time, std::vector<std::string>& output) {
 
 // Transition scheduled flights to in-progress when their start time arrives
 void Scheduler::promoteToInProgress(int time) {
-    for (auto& pair : activeFlights) {
-        Flight& flight = pair.second;
-        if (flight.state == SCHEDULED && flight.startTime <= time) {
-            flight.state = IN_PROGRESS;
+    STATS_TIMER(stats.promote);
+    while (!startQueue.empty() && startQueue.top().startTime <= time) {
+        int flightID = startQueue.topID();
+        startQueue.pop();
+        STATS_ADD(flightsPromoted, 1);
+        
+        int slot = flights.find(flightID);
+        int runwayID = flights.runwayIDs[slot];
+        flights.states[slot] = IN_PROGRESS;
+        touchView(flightID);
+        etaIndex.erase(std::make_pair(flights.ETAs[slot], flightID));
+        unsatisfiedFlights.erase(flightID);
+        dropFromPlan(runwayID, flightID);
+        
+        if (runwayID > 0) {
+            if (runwayID >= (int)runwayBusyUntil.size()) {
+                runwayBusyUntil.resize(runwayID + 1, -1);
+            }
+            runwayBusyUntil[runwayID] = std::max(runwayBusyUntil[runwayID], flights.ETAs[slot]);
         }
     }
+    startedUnpromoted = false;
+}
+
+// Remove a started or landed flight from its runway plan
+void Scheduler::dropFromPlan(int runwayID, int flightID) {
+    if (runwayID <= 0 || runwayID >= (int)runwayPlans.size()) return;
+    
+    // Departures leave from the front of the plan except for ties
+    std::deque<int>& plan = runwayPlans[runwayID];
+    if (!plan.empty() && plan.front() == flightID) {
+        plan.pop_front();
+        return;
+    }
+    auto it = std::find(plan.begin(), plan.end(), flightID);
+    if (it != plan.end()) {
+        plan.erase(it);
+    }
 }
 
 // Identify flights that haven't been assigned or need rescheduling
 std::vector<int> Scheduler::getUnsatisfiedFlights() {
     std::vector<int> unsatisfied;
+    unsatisfied.reserve(unsatisfiedFlights.size());
     
-    for (auto& pair : activeFlights) {
-        Flight& flight = pair.second;
-        if (flight.state == PENDING || 
-            (flight.state == SCHEDULED && flight.startTime > currentTime)) {
-            unsatisfied.push_back(flight.flightID);
+    for (int flightID : unsatisfiedFlights) {
+        int slot = flights.find(flightID);
+        if (flights.states[slot] == PENDING || 
+            (flights.states[slot] == SCHEDULED && flights.startTimes[slot] > currentTime)) {
+            unsatisfied.push_back(slot);
         }
     }
     
     return unsatisfied;
 }
 
-// Reassign unsatisfied flights to available runways using greedy scheduling
-void Scheduler::rescheduleUnsatisfied(std::vector<std::string>& output) {
-    std::vector<int> unsatisfiedIDs = getUnsatisfiedFlights();
-    if (unsatisfiedIDs.empty()) return;
-    
-    std::unordered_map<int, int> oldETAs;
-    for (int fid : unsatisfiedIDs) {
-        auto it = activeFlights.find(fid);
-        if (it != activeFlights.end() && it->second.ETA != -1) {
-            oldETAs[fid] = it->second.ETA;
-        }
+// Earliest time a runway can take a new flight
+int Scheduler::runwayFreeAt(int runwayID) const {
+    if (runwayID < (int)runwayBusyUntil.size()) {
+        return std::max(currentTime, runwayBusyUntil[runwayID]);
     }
+    return currentTime;
+}
+
+// Record the earliest greedy position affected by a mutation
+void Scheduler::markDirty(const PlanKey& key) {
+    if (!planDirty || key.precedes(dirtyKey)) {
+        dirtyKey = key;
+    }
+    planDirty = true;
+}
+
+// Position of the first plan entry that does not precede key
+std::deque<int>::iterator Scheduler::planLowerBound(std::deque<int>& plan, const PlanKey& key) {
+    return std::lower_bound(plan.begin(), plan.end(), key,
+                            [this](int fid, const PlanKey& k) {
+                                return flights.planKey(flights.find(fid)).precedes(k);
+                            });
+}
+
+// Take a scheduled flight off its runway plan and mark its slot dirty
+void Scheduler::detachFromPlan(int slot) {
+    PlanKey key = flights.planKey(slot);
+    markDirty(key);
     
-    // Clear old assignments
-    for (int fid : unsatisfiedIDs) {
-        auto it = activeFlights.find(fid);
-        if (it != activeFlights.end()) {
-            Flight& flight = it->second;
-            flight.state = PENDING;
-            flight.runwayID = -1;
-            flight.startTime = -1;
-            flight.ETA = -1;
-        }
+    int runwayID = flights.runwayIDs[slot];
+    if (runwayID <= 0 || runwayID >= (int)runwayPlans.size()) return;
+    
+    std::deque<int>& plan = runwayPlans[runwayID];
+    auto it = planLowerBound(plan, key);
+    if (it != plan.end() && *it == key.flightID) {
+        plan.erase(it);
     }
+}
+
+// Reassign unsatisfied flights and report the ETAs that moved
+void Scheduler::rescheduleUnsatisfied(OutputSink& output) {
+    replanDirty();
+    reportUpdatedETAs(output);
+}
+
+// Replan only what the last mutations touched
+void Scheduler::replanDirty() {
+    STATS_TIMER(stats.reschedule);
+    if (!planValid || startedUnpromoted) {
+        replanAllFlights();
+    } else if (planDirty || replanAll) {
+        replanSuffix();
+    }
+    
+    planDirty = false;
+    replanAll = false;
+}
+
+// Print the ETA changes collected by the last replan, by flightID
+void Scheduler::reportUpdatedETAs(OutputSink& output) {
+    printUpdatedETAs(updatedETAs, output);
+    updatedETAs.clear();
+}
+
+// Print (flightID, ETA) changes as one line, sorted by flightID
+void Scheduler::printUpdatedETAs(std::vector<std::pair<int, int>>& changes, 
+                                 OutputSink& output) {
+    if (changes.empty()) return;
     
-    // Build pending heap with all unsatisfied flights
-    pendingFlights.clear();
+    std::sort(changes.begin(), changes.end());
     
-    for (int fid : unsatisfiedIDs) {
-        auto it = activeFlights.find(fid);
-        if (it != activeFlights.end()) {
-            pendingFlights.push(&it->second);
-        }
+    output << "Updated ETAs: [";
+    for (size_t i = 0; i < changes.size(); i++) {
+        if (i > 0) output << ", ";
+        output << changes[i].first << ": " << changes[i].second;
+    }
+    output << "]";
+    output.endl();
+}
+
+// Print landing lines in the order given
+void Scheduler::printLanded(const std::vector<TimetableEntry>& landed, OutputSink& output) {
+    for (const auto& entry : landed) {
+        output << "Flight " << entry.flightID << " has landed at time " << entry.ETA;
+        output.endl();
     }
+}
+
+// Print and clear landings and moved ETAs from the last advance
+void Scheduler::reportEvents(OutputSink& output) {
+    printLanded(landedFlights, output);
+    landedFlights.clear();
+    reportUpdatedETAs(output);
+}
+
+// Hand over landings and moved ETAs instead of printing them
+void Scheduler::takeEvents(std::vector<TimetableEntry>& landed, 
+                           std::vector<std::pair<int, int>>& updated) {
+    landed.insert(landed.end(), landedFlights.begin(), landedFlights.end());
+    updated.insert(updated.end(), updatedETAs.begin(), updatedETAs.end());
+    landedFlights.clear();
+    updatedETAs.clear();
+}
+
+// Full greedy pass over every unsatisfied flight
+void Scheduler::replanAllFlights() {
+    STATS_ADD(fullReplans, 1);
+    std::vector<int> unsatisfiedSlots = getUnsatisfiedFlights();
+    
+    // Flights that started without being promoted hold no runway here, so
+    // the resulting plan cannot be extended incrementally
+    planValid = !startedUnpromoted && nextRunwayID > 1;
+    runwayPlans.assign(nextRunwayID, std::deque<int>());
+    
+    if (unsatisfiedSlots.empty()) return;
     
-    // Rebuild runway pool
-    MinHeap<Runway> newRunwayPool;
+    runwayPool.clear();
     for (int i = 1; i < nextRunwayID; i++) {
-        int nextFree = currentTime;
-        
-        for (auto& pair : activeFlights) {
-            Flight& flight = pair.second;
-            if (flight.state == IN_PROGRESS && flight.runwayID == i) {
-                nextFree = std::max(nextFree, flight.ETA);
-            }
-        }
-        
-        newRunwayPool.push(Runway(i, nextFree));
+        runwayPool.push(i, Runway(i, runwayFreeAt(i)));
     }
-    runwayPool = newRunwayPool;
     
-    // Clear timetable for unsatisfied flights
-    MinHeap<TimetableEntry> newTimetable;
-    std::unordered_set<int> unsatisfiedSet(unsatisfiedIDs.begin(), unsatisfiedIDs.end());
+    // Pending flights are already queued
+    for (int slot : unsatisfiedSlots) {
+        if (flights.states[slot] == SCHEDULED) {
+            enqueuePending(slot);
+        }
+    }
     
-    std::vector<TimetableEntry> allEntries;
-    while (!timetable.empty()) {
-        allEntries.push_back(timetable.top());
-        timetable.pop();
+    assignGreedy();
+}
+
+// Replan the greedy suffix starting at dirtyKey; the prefix is unchanged
+void Scheduler::replanSuffix() {
+    if (nextRunwayID <= 1) {
+        replanAllFlights();
+        return;
     }
+    STATS_ADD(suffixReplans, 1);
+    
+    runwayPool.clear();
     
-    for (const auto& entry : allEntries) {
-        if (unsatisfiedSet.find(entry.flightID) == unsatisfiedSet.end()) {
-            newTimetable.push(entry);
+    for (int r = 1; r < nextRunwayID; r++) {
+        std::deque<int>& plan = runwayPlans[r];
+        auto cut = replanAll ? plan.begin() : planLowerBound(plan, dirtyKey);
+        
+        // Runway state after the untouched prefix
+        int nextFree;
+        if (cut != plan.begin()) {
+            nextFree = flights.ETAs[flights.find(*(cut - 1))];
+        } else {
+            nextFree = runwayFreeAt(r);
         }
+        runwayPool.push(r, Runway(r, nextFree));
+        
+        for (auto it = cut; it != plan.end(); ++it) {
+            enqueuePending(flights.find(*it));
+        }
+        plan.erase(cut, plan.end());
     }
-    timetable = newTimetable;
     
-    // Schedule flights greedily
-    while (!pendingFlights.empty()) {
-        Flight* flight = pendingFlights.top();
+    assignGreedy();
+}
+
+// Queue a flight for assignment, keeping its old slot for change reporting
+void Scheduler::enqueuePending(int slot) {
+    flights.states[slot] = PENDING;
+    touchView(flights.flightIDs[slot]);
+    pendingNodes[flights.flightIDs[slot]] = pendingFlights.push(flights.planKey(slot), slot);
+}
+
+// Greedily assign queued flights in priority order, collecting changed ETAs
+void Scheduler::assignGreedy() {
+    // Assigned flights with their previous (ETA, runway)
+    std::vector<int> assigned;
+    std::vector<std::pair<int, int>> previous;
+    assigned.reserve(pendingFlights.size());
+    previous.reserve(pendingFlights.size());
+    
+    // Schedule flights greedily; without runways they stay queued
+    while (!pendingFlights.empty() && !runwayPool.empty()) {
+        int slot = pendingFlights.top();
         pendingFlights.pop();
+        pendingNodes.erase(flights.flightIDs[slot]);
+        STATS_ADD(pendingPops, 1);
         
-        if (runwayPool.empty()) break;
+        assigned.push_back(slot);
+        previous.push_back(std::make_pair(flights.ETAs[slot], flights.runwayIDs[slot]));
         
         Runway runway = runwayPool.top();
-        runwayPool.pop();
         
         int startTime = std::max(currentTime, runway.nextFreeTime);
-        int ETA = startTime + flight->duration;
+        int ETA = startTime + flights.durations[slot];
         
-        flight->runwayID = runway.runwayID;
-        flight->startTime = startTime;
-        flight->ETA = ETA;
-        flight->state = SCHEDULED;
+        flights.runwayIDs[slot] = runway.runwayID;
+        flights.startTimes[slot] = startTime;
+        flights.ETAs[slot] = ETA;
+        flights.states[slot] = SCHEDULED;
+        touchView(flights.flightIDs[slot]);
         
         runway.nextFreeTime = ETA;
-        runwayPool.push(runway);
+        runwayPool.update(runway.runwayID, runway);
         
-        timetable.push(TimetableEntry(ETA, flight->flightID, runway.runwayID));
-    }
-    
-    // Check for ETA changes
-    std::vector<std::pair<int, int>> changedETAs;
-    for (int fid : unsatisfiedIDs) {
-        auto it = activeFlights.find(fid);
-        if (it != activeFlights.end() && it->second.ETA != -1) {
-            auto oldIt = oldETAs.find(fid);
-            if (oldIt != oldETAs.end()) {  // Only if there WAS an old ETA
-                int oldETA = oldIt->second;
-                if (oldETA != it->second.ETA) {
-                    changedETAs.push_back({fid, it->second.ETA});
-                }
-            }
+        if (startTime <= currentTime) {
+            startedUnpromoted = true;
         }
+        runwayPlans[runway.runwayID].push_back(flights.flightIDs[slot]);
     }
+    STATS_ADD(flightsReplanned, assigned.size());
     
-    if (!changedETAs.empty()) {
-        std::sort(changedETAs.begin(), changedETAs.end());
+    // Re-key timetable entries only for flights whose slot moved
+    for (size_t i = 0; i < assigned.size(); i++) {
+        int slot = assigned[i];
+        int flightID = flights.flightIDs[slot];
+        int ETA = flights.ETAs[slot];
+        if (ETA == previous[i].first && flights.runwayIDs[slot] == previous[i].second) {
+            continue;
+        }
         
-        std::ostringstream oss;
-        oss << "Updated ETAs: [";
-        for (size_t i = 0; i < changedETAs.size(); i++) {
-            if (i > 0) oss << ", ";
-            oss << changedETAs[i].first << ": " << changedETAs[i].second;
+        timetable.update(flightID, TimetableEntry(ETA, flightID, flights.runwayIDs[slot]));
+        if (ETA != previous[i].first) {
+            etaIndex.erase(std::make_pair(previous[i].first, flightID));
+            etaIndex.insert(std::make_pair(ETA, flightID));
+        }
+        startQueue.update(flightID, StartEntry(flights.startTimes[slot], flightID));
+        STATS_ADD(timetableUpdates, 1);
+        
+        if (previous[i].first != -1 && ETA != previous[i].first) {
+            updatedETAs.push_back(std::make_pair(flightID, ETA));
+            STATS_ADD(etasUpdated, 1);
         }
-        oss << "]";
-        output.push_back(oss.str());
     }
 }
 
 // Update scheduler state and process all events at given time
-void Scheduler::advanceTime(int time, std::vector<std::string>& output) {
+void Scheduler::advanceTime(int time, OutputSink& output) {
+    advanceSilently(time);
+    reportEvents(output);
+}
+
+// Advance to time, collecting landings and moved ETAs without printing
+void Scheduler::advanceSilently(int time) {
     if (time == currentTime) {
         promoteToInProgress(time);
-        rescheduleUnsatisfied(output);
+        replanDirty();
         return;
     }
     
+    // Moving backwards in time invalidates runway availability
+    if (time < currentTime) {
+        planValid = false;
+    }
+    
     currentTime = time;
-    settleCompletions(time, output);
+    settleCompletions(time);
     promoteToInProgress(time);
-    rescheduleUnsatisfied(output);
+    replanDirty();
+}
+
+// Drop a flight from the table, fixing the queue handle of the flight
+// that moves into its slot
+void Scheduler::eraseFlight(int slot) {
+    touchView(flights.flightIDs[slot]);
+    int movedFrom = flights.erase(slot);
+    if (movedFrom != -1 && flights.states[slot] == PENDING) {
+        pendingNodes.find(flights.flightIDs[slot])->second->slot = slot;
+    }
 }
 
 // Remove flight from all data structures
 void Scheduler::removeFlightFromStructures(int flightID) {
-    auto it = activeFlights.find(flightID);
-    if (it == activeFlights.end()) return;
+    int slot = flights.find(flightID);
+    if (slot == -1) return;
+    STATS_ADD(flightsRemoved, 1);
     
-    Flight& flight = it->second;
+    // Remove from the runway plan
+    if (flights.states[slot] == SCHEDULED) {
+        detachFromPlan(slot);
+    } else if (flights.states[slot] == PENDING) {
+        markDirty(flights.planKey(slot));
+        pendingFlights.erase(pendingNodes[flightID]);
+        pendingNodes.erase(flightID);
+    }
     
     // Remove from airline index
-    auto ait = airlineIndex.find(flight.airlineID);
+    auto ait = airlineIndex.find(flights.airlineIDs[slot]);
     if (ait != airlineIndex.end()) {
         ait->second.erase(flightID);
         if (ait->second.empty()) {
@@ -211,169 +409,215 @@ void Scheduler::removeFlightFromStructures(int flightID) {
         }
     }
     
-    // Remove from timetable
-    std::vector<TimetableEntry> remaining;
-    while (!timetable.empty()) {
-        TimetableEntry entry = timetable.top();
-        timetable.pop();
-        if (entry.flightID != flightID) {
-            remaining.push_back(entry);
-        }
-    }
-    for (const auto& entry : remaining) {
-        timetable.push(entry);
-    }
+    // Remove from timetable, departure queue and ETA index
+    etaIndex.erase(std::make_pair(flights.ETAs[slot], flightID));
+    timetable.erase(flightID);
+    startQueue.erase(flightID);
+    unsatisfiedFlights.erase(flightID);
     
-    activeFlights.erase(it);
+    eraseFlight(slot);
 }
 
 // Initialize scheduler with available runways
-void Scheduler::initialize(int runwayCount, std::vector<std::string>& output) {
+void Scheduler::initialize(int runwayCount, OutputSink& output) {
     if (runwayCount <= 0) {
-        output.push_back("Invalid input. Please provide a valid number of runways.");
+        output << "Invalid input. Please provide a valid number of runways.";
+        output.endl();
         return;
     }
     
     currentTime = 0;
     nextRunwayID = 1;
+    planValid = false;
+    
+    // Moving currentTime back can list flights without touching them, so
+    // the view sets are rebuilt on the next refreshView
+    viewTracked = false;
+    viewTouched.clear();
+    viewActive.clear();
+    viewScheduled.clear();
     
     for (int i = 0; i < runwayCount; i++) {
-        runwayPool.push(Runway(nextRunwayID++, 0));
+        runwayPool.update(nextRunwayID, Runway(nextRunwayID, 0));
+        nextRunwayID++;
     }
     
-    output.push_back(std::to_string(runwayCount) + " Runways are now available");
+    output << runwayCount << " Runways are now available";
+    output.endl();
 }
 
 // Add new flight to scheduler and assign runway
 void Scheduler::submitFlight(int flightID, int airlineID, int submitTime, 
-                            int priority, int duration, std::vector<std::string>& output) {
+                            int priority, int duration, OutputSink& output) {
     advanceTime(submitTime, output);
-    
-    if (activeFlights.find(flightID) != activeFlights.end()) {
-        output.push_back("Duplicate FlightID");
+    admitFlight(Flight(flightID, airlineID, submitTime, priority, duration), output);
+}
+
+// Insert a flight at currentTime and replan from its greedy position
+void Scheduler::admitFlight(const Flight& request, OutputSink& output) {
+    int flightID = request.flightID;
+    if (flights.find(flightID) != -1) {
+        output << "Duplicate FlightID";
+        output.endl();
         return;
     }
     
-    Flight flight(flightID, airlineID, submitTime, priority, duration);
-    activeFlights[flightID] = flight;
+    int slot = flights.insert(request);
     
-    airlineIndex[airlineID].insert(flightID);
+    airlineIndex[request.airlineID].insert(flightID);
+    unsatisfiedFlights.insert(flightID);
     
-    // Store size before to check if we need Updated ETAs output
-    size_t outputSizeBefore = output.size();
-    rescheduleUnsatisfied(output);
+    enqueuePending(slot);
+    markDirty(flights.planKey(slot));
     
-    // Print the new flight's ETA first
-    auto it = activeFlights.find(flightID);
-    if (it != activeFlights.end()) {
-        // If reschedule printed Updated ETAs, we need to reorder output
-        if (output.size() > outputSizeBefore && 
-            output.back().find("Updated ETAs:") == 0) {
-            std::string updatedETAs = output.back();
-            output.pop_back();
-            output.push_back("Flight " + std::to_string(flightID) + 
-                            " scheduled - ETA: " + std::to_string(it->second.ETA));
-            output.push_back(updatedETAs);
-        } else {
-            output.push_back("Flight " + std::to_string(flightID) + 
-                            " scheduled - ETA: " + std::to_string(it->second.ETA));
-        }
-    }
+    // The new flight's ETA is printed before the flights it displaced
+    replanDirty();
+    
+    slot = flights.find(flightID);
+    output << "Flight " << flightID << " scheduled - ETA: " << flights.ETAs[slot];
+    output.endl();
+    reportUpdatedETAs(output);
 }
 
 // Remove flight from schedule if not already in progress
-void Scheduler::cancelFlight(int flightID, int time, std::vector<std::string>& output) {
+void Scheduler::cancelFlight(int flightID, int time, OutputSink& output) {
     advanceTime(time, output);
-    
-    auto it = activeFlights.find(flightID);
-    if (it == activeFlights.end()) {
-        output.push_back("Flight " + std::to_string(flightID) + " does not exist");
+    withdrawFlight(flightID, output);
+}
+
+// Cancel a flight at currentTime
+void Scheduler::withdrawFlight(int flightID, OutputSink& output) {
+    int slot = flights.find(flightID);
+    if (slot == -1) {
+        output << "Flight " << flightID << " does not exist";
+        output.endl();
         return;
     }
     
-    Flight& flight = it->second;
-    
-    if (flight.state == IN_PROGRESS || flight.state == COMPLETED) {
-        output.push_back("Cannot cancel. Flight " + std::to_string(flightID) + 
-                        " has already departed");
+    if (flights.states[slot] == IN_PROGRESS || flights.states[slot] == COMPLETED) {
+        output << "Cannot cancel. Flight " << flightID << " has already departed";
+        output.endl();
         return;
     }
     
     removeFlightFromStructures(flightID);
     
-    output.push_back("Flight " + std::to_string(flightID) + " has been canceled");
+    output << "Flight " << flightID << " has been canceled";
+    output.endl();
     
     rescheduleUnsatisfied(output);
 }
 
 // Update flight priority and reschedule if pending
 void Scheduler::reprioritize(int flightID, int time, int newPriority, 
-                            std::vector<std::string>& output) {
+                            OutputSink& output) {
     advanceTime(time, output);
-    
-    auto it = activeFlights.find(flightID);
-    if (it == activeFlights.end()) {
-        output.push_back("Flight " + std::to_string(flightID) + " not found");
+    changePriority(flightID, newPriority, output);
+}
+
+// Reprioritize a flight at currentTime
+void Scheduler::changePriority(int flightID, int newPriority, OutputSink& output) {
+    int slot = flights.find(flightID);
+    if (slot == -1) {
+        output << "Flight " << flightID << " not found";
+        output.endl();
         return;
     }
     
-    Flight& flight = it->second;
-    
-    if (flight.state == IN_PROGRESS || flight.state == COMPLETED) {
-        output.push_back("Cannot reprioritize. Flight " + std::to_string(flightID) + 
-                        " has already departed");
+    if (flights.states[slot] == IN_PROGRESS || flights.states[slot] == COMPLETED) {
+        output << "Cannot reprioritize. Flight " << flightID << " has already departed";
+        output.endl();
         return;
     }
     
-    flight.priority = newPriority;
-    
-    output.push_back("Priority of Flight " + std::to_string(flightID) + 
-                    " has been updated to " + std::to_string(newPriority));
+    // Requeue with the new priority; queued flights are re-keyed in place.
+    // A flight starting now but not yet promoted keeps its slot.
+    markDirty(flights.planKey(slot));
+    if (flights.states[slot] == SCHEDULED && flights.startTimes[slot] <= currentTime) {
+        flights.priorities[slot] = newPriority;
+    } else if (flights.states[slot] == SCHEDULED) {
+        detachFromPlan(slot);
+        flights.priorities[slot] = newPriority;
+        enqueuePending(slot);
+    } else if (newPriority >= flights.priorities[slot]) {
+        flights.priorities[slot] = newPriority;
+        pendingFlights.increaseKey(pendingNodes[flightID], newPriority);
+    } else {
+        pendingFlights.erase(pendingNodes[flightID]);
+        flights.priorities[slot] = newPriority;
+        pendingNodes[flightID] = pendingFlights.push(flights.planKey(slot), slot);
+    }
+    markDirty(flights.planKey(slot));
+    
+    output << "Priority of Flight " << flightID << " has been updated to " << newPriority;
+    output.endl();
     
     rescheduleUnsatisfied(output);
 }
 
 // Add runways and reschedule affected flights
-void Scheduler::addRunways(int count, int time, std::vector<std::string>& output) {
+void Scheduler::addRunways(int count, int time, OutputSink& output) {
     advanceTime(time, output);
-    
+    openRunways(count, output);
+}
+
+// Add runways at currentTime
+void Scheduler::openRunways(int count, OutputSink& output) {
     if (count <= 0) {
-        output.push_back("Invalid input. Please provide a valid number of runways.");
+        output << "Invalid input. Please provide a valid number of runways.";
+        output.endl();
         return;
     }
     
     for (int i = 0; i < count; i++) {
-        runwayPool.push(Runway(nextRunwayID++, currentTime));
+        runwayPool.update(nextRunwayID, Runway(nextRunwayID, currentTime));
+        nextRunwayID++;
     }
+    runwayPlans.resize(nextRunwayID);
+    replanAll = true;
     
-    output.push_back("Additional " + std::to_string(count) + " Runways are now available");
+    output << "Additional " << count << " Runways are now available";
+    output.endl();
     
     rescheduleUnsatisfied(output);
 }
 
 // Cancel all pending flights for airlines in given range
 void Scheduler::groundHold(int airlineLow, int airlineHigh, int time, 
-                          std::vector<std::string>& output) {
+                          OutputSink& output) {
     advanceTime(time, output);
     
     if (airlineHigh < airlineLow) {
-        output.push_back("Invalid input. Please provide a valid airline range.");
+        output << "Invalid input. Please provide a valid airline range.";
+        output.endl();
         return;
     }
     
+    groundAirlines(airlineLow, airlineHigh);
+    
+    output << "Flights of the airlines in the range [" << airlineLow << ", " 
+           << airlineHigh << "] have been grounded";
+    output.endl();
+    
+    rescheduleUnsatisfied(output);
+}
+
+// Remove the airlines' flights that have not started; replanning is left
+// to the caller
+void Scheduler::groundAirlines(int airlineLow, int airlineHigh) {
     std::vector<int> toRemove;
     
-    for (int airlineID = airlineLow; airlineID <= airlineHigh; airlineID++) {
-        auto it = airlineIndex.find(airlineID);
-        if (it != airlineIndex.end()) {
-            for (int flightID : it->second) {
-                auto fit = activeFlights.find(flightID);
-                if (fit != activeFlights.end()) {
-                    Flight& flight = fit->second;
-                    if (flight.state == PENDING || 
-                        (flight.state == SCHEDULED && flight.startTime > currentTime)) {
-                        toRemove.push_back(flightID);
-                    }
+    // Visit only airlines that exist in the range
+    auto first = airlineIndex.lower_bound(airlineLow);
+    auto last = airlineIndex.upper_bound(airlineHigh);
+    for (auto it = first; it != last; ++it) {
+        for (int flightID : it->second) {
+            int slot = flights.find(flightID);
+            if (slot != -1) {
+                if (flights.states[slot] == PENDING || 
+                    (flights.states[slot] == SCHEDULED && 
+                     flights.startTimes[slot] > currentTime)) {
+                    toRemove.push_back(flightID);
                 }
             }
         }
@@ -382,70 +626,331 @@ void Scheduler::groundHold(int airlineLow, int airlineHigh, int time,
     for (int flightID : toRemove) {
         removeFlightFromStructures(flightID);
     }
-    
-    output.push_back("Flights of the airlines in the range [" + 
-                    std::to_string(airlineLow) + ", " + 
-                    std::to_string(airlineHigh) + "] have been grounded");
-    
-    rescheduleUnsatisfied(output);
 }
 
 // Display all active flights sorted by ID
-void Scheduler::printActive(std::vector<std::string>& output) {
-    if (activeFlights.empty()) {
-        output.push_back("No active flights");
+void Scheduler::printActive(OutputSink& output) {
+    if (flights.empty()) {
+        output << "No active flights";
+        output.endl();
         return;
     }
     
-    std::vector<Flight> flights;
-    for (auto& pair : activeFlights) {
-        flights.push_back(pair.second);
+    // Radix sort (flightID, slot) pairs; the buffers are reused across calls
+    size_t count = flights.size();
+    printOrder.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        printOrder[i] = radixItem(flights.flightIDs[i], (int)i);
     }
+    radixSortByKey(printOrder, printScratch);
     
-    std::sort(flights.begin(), flights.end(), 
-              [](const Flight& a, const Flight& b) { return a.flightID < b.flightID; });
-    
-    for (const auto& flight : flights) {
-        std::ostringstream oss;
-        oss << "[flight" << flight.flightID 
-            << ", airline" << flight.airlineID 
-            << ", runway" << flight.runwayID 
-            << ", start" << flight.startTime 
-            << ", ETA" << flight.ETA << "]";
-        output.push_back(oss.str());
+    for (uint64_t item : printOrder) {
+        printActiveLine(flights.get(radixPayload(item)), output);
+    }
+}
+
+// One printActive line
+void Scheduler::printActiveLine(const Flight& flight, OutputSink& output) {
+    output << "[flight" << flight.flightID 
+           << ", airline" << flight.airlineID 
+           << ", runway" << flight.runwayID 
+           << ", start" << flight.startTime 
+           << ", ETA" << flight.ETA << "]";
+    output.endl();
+}
+
+// Append every active flight
+void Scheduler::collectActive(std::vector<Flight>& out) const {
+    for (size_t i = 0; i < flights.size(); i++) {
+        out.push_back(flights.get((int)i));
     }
 }
 
 // Display scheduled flights within time range, sorted by ETA
-void Scheduler::printSchedule(int t1, int t2, std::vector<std::string>& output) {
-    std::vector<Flight> scheduled;
-    
-    for (auto& pair : activeFlights) {
-        Flight& flight = pair.second;
-        if (flight.state == SCHEDULED && 
-            flight.startTime > currentTime &&
-            flight.ETA >= t1 && flight.ETA <= t2) {
-            scheduled.push_back(flight);
+void Scheduler::printSchedule(int t1, int t2, OutputSink& output) {
+    scheduleBuffer.clear();
+    collectScheduled(t1, t2, scheduleBuffer);
+    printScheduleLines(scheduleBuffer, output);
+}
+
+// Walk the ETA index from t1; flights that already started are skipped
+void Scheduler::collectScheduled(int t1, int t2, 
+                                 std::vector<std::pair<int, int>>& out) const {
+    auto it = etaIndex.lower_bound(std::make_pair(t1, INT_MIN));
+    for (; it != etaIndex.end() && it->first <= t2; ++it) {
+        if (listed(flights.find(it->second))) {
+            out.push_back(*it);
         }
     }
+}
+
+// Scheduled and not yet started, not even unpromoted at currentTime
+bool Scheduler::listed(int slot) const {
+    return flights.states[slot] == SCHEDULED && flights.startTimes[slot] > currentTime;
+}
+
+// A listed flight stays listed until it is promoted, moved or removed, and
+// each of those touches it, so only touched flights need revisiting
+// (initialize, which moves currentTime back, drops the sets instead). Nodes
+// are copied only for flights whose printed fields or listing changed.
+void Scheduler::refreshView() {
+    if (!viewTracked) {
+        viewTracked = true;
+        for (size_t i = 0; i < flights.size(); i++) {
+            viewActive.insert(flights.get((int)i));
+            if (listed((int)i)) {
+                viewScheduled.insert(std::make_pair(flights.ETAs[i], flights.flightIDs[i]));
+            }
+        }
+        return;
+    }
     
+    std::sort(viewTouched.begin(), viewTouched.end());
+    viewTouched.erase(std::unique(viewTouched.begin(), viewTouched.end()), viewTouched.end());
+    for (int flightID : viewTouched) {
+        const Flight* old = viewActive.find(Flight(flightID, 0, 0, 0, 0));
+        bool wasListed = old && viewScheduled.find(std::make_pair(old->ETA, flightID));
+        std::pair<int, int> oldKey = old ? std::make_pair(old->ETA, flightID)
+                                         : std::make_pair(0, flightID);
+        
+        int slot = flights.find(flightID);
+        if (slot == -1) {
+            if (wasListed) viewScheduled.erase(oldKey);
+            if (old) viewActive.erase(Flight(flightID, 0, 0, 0, 0));
+            continue;
+        }
+        
+        Flight flight = flights.get(slot);
+        bool isListed = listed(slot);
+        std::pair<int, int> key = std::make_pair(flight.ETA, flightID);
+        if (wasListed && (!isListed || key != oldKey)) {
+            viewScheduled.erase(oldKey);
+        }
+        if (isListed && (!wasListed || key != oldKey)) {
+            viewScheduled.insert(key);
+        }
+        if (!old || old->airlineID != flight.airlineID || old->runwayID != flight.runwayID ||
+            old->startTime != flight.startTime || old->ETA != flight.ETA) {
+            viewActive.insert(flight);
+        }
+    }
+    viewTouched.clear();
+}
+
+// PrintSchedule lines for (ETA, flightID) pairs already in order
+void Scheduler::printScheduleLines(const std::vector<std::pair<int, int>>& scheduled, 
+                                   OutputSink& output) {
     if (scheduled.empty()) {
-        output.push_back("There are no flights in that time period");
+        output << "There are no flights in that time period";
+        output.endl();
         return;
     }
     
-    std::sort(scheduled.begin(), scheduled.end(), 
-              [](const Flight& a, const Flight& b) {
-                  if (a.ETA != b.ETA) return a.ETA < b.ETA;
-                  return a.flightID < b.flightID;
-              });
-    
-    for (const auto& flight : scheduled) {
-        output.push_back("[" + std::to_string(flight.flightID) + "]");
+    for (const auto& entry : scheduled) {
+        output << "[" << entry.second << "]";
+        output.endl();
     }
 }
 
 // Advance time and process all state changes
-void Scheduler::tick(int time, std::vector<std::string>& output) {
+void Scheduler::tick(int time, OutputSink& output) {
     advanceTime(time, output);
-}
\ No newline at end of file
+}
+
+// Print instrumentation counters and current structure sizes
+void Scheduler::printStats(OutputSink& output) {
+#ifdef SCHEDULER_STATS
+    stats.print(output);
+    output << "sizes activeFlights=" << (int)flights.size() 
+           << " pending=" << (int)pendingFlights.size() 
+           << " timetable=" << (int)timetable.size() 
+           << " startQueue=" << (int)startQueue.size() 
+           << " runways=" << nextRunwayID - 1;
+    output.endl();
+#else
+    output << "Statistics are not enabled";
+    output.endl();
+#endif
+}
+
+// Write the authoritative state; everything else is derived on load
+void Scheduler::saveState(SnapshotWriter& writer) const {
+    writer.putInt(currentTime);
+    writer.putInt(nextRunwayID);
+    writer.putInt((int)runwayBusyUntil.size());
+    writer.putInt((int)flights.size());
+    writer.putInts(runwayBusyUntil);
+    
+    writer.putInts(flights.flightIDs);
+    writer.putInts(flights.airlineIDs);
+    writer.putInts(flights.submitTimes);
+    writer.putInts(flights.priorities);
+    writer.putInts(flights.durations);
+    writer.putInts(flights.runwayIDs);
+    writer.putInts(flights.startTimes);
+    writer.putInts(flights.ETAs);
+    writer.putBytes(flights.states);
+}
+
+// Read the columns back and rebuild every index in one pass. The runway
+// plans are left invalid, so the next command replans from scratch and
+// reaches the plan the saved scheduler had.
+bool Scheduler::loadState(SnapshotReader& reader) {
+    int busyCount;
+    int flightCount;
+    if (!reader.getInt(currentTime) || !reader.getInt(nextRunwayID) ||
+        !reader.getInt(busyCount) || !reader.getInt(flightCount)) {
+        return false;
+    }
+    if (nextRunwayID < 1 || busyCount < 0 || flightCount < 0) return false;
+    if (!reader.getInts(runwayBusyUntil, busyCount)) return false;
+    
+    std::vector<int> columns[8];
+    std::vector<unsigned char> states;
+    for (int c = 0; c < 8; c++) {
+        if (!reader.getInts(columns[c], flightCount)) return false;
+    }
+    if (!reader.getBytes(states, flightCount)) return false;
+    
+    for (int i = 0; i < flightCount; i++) {
+        Flight flight(columns[0][i], columns[1][i], columns[2][i], columns[3][i], 
+                      columns[4][i]);
+        flight.runwayID = columns[5][i];
+        flight.startTime = columns[6][i];
+        flight.ETA = columns[7][i];
+        flight.state = (FlightState)states[i];
+        if (states[i] > COMPLETED || flights.find(flight.flightID) != -1) return false;
+        
+        int slot = flights.insert(flight);
+        int flightID = flight.flightID;
+        airlineIndex[flight.airlineID].insert(flightID);
+        
+        if (flight.ETA != -1) {
+            timetable.push(flightID, TimetableEntry(flight.ETA, flightID, flight.runwayID));
+        }
+        if (flight.state == PENDING || flight.state == SCHEDULED) {
+            unsatisfiedFlights.insert(flightID);
+            if (flight.ETA != -1) {
+                startQueue.push(flightID, StartEntry(flight.startTime, flightID));
+                etaIndex.insert(std::make_pair(flight.ETA, flightID));
+            }
+        }
+        if (flight.state == PENDING) {
+            pendingNodes[flightID] = pendingFlights.push(flights.planKey(slot), slot);
+        }
+    }
+    
+    for (int r = 1; r < nextRunwayID; r++) {
+        runwayPool.push(r, Runway(r, runwayFreeAt(r)));
+    }
+    runwayPlans.assign(nextRunwayID, std::deque<int>());
+    planValid = false;
+    return true;
+}
+
+// Copy every structure; the pending heap's copy has new nodes, so their
+// handles are collected again by walking it
+std::unique_ptr<Scheduler> Scheduler::fork() const {
+    std::unique_ptr<Scheduler> branch(new Scheduler(*this));
+    branch->collectPendingHandles();
+    return branch;
+}
+
+// Copy-assign every structure, then collect the new heap handles
+void Scheduler::copyFrom(const Scheduler& other) {
+    if (this == &other) return;
+    *this = other;
+    collectPendingHandles();
+}
+
+// Walk the pending heap for the node of each queued flight
+void Scheduler::collectPendingHandles() {
+    pendingNodes.clear();
+    pendingFlights.visitNodes([this](PendingQueue::Node* node) {
+        pendingNodes[flights.flightIDs[node->slot]] = node;
+    });
+}
+
+// Durations are not part of the greedy key, so only the plan is redone
+void Scheduler::redrawDurations(const std::function<int(int, int)>& draw) {
+    // Flights a replan started at currentTime keep their durations; the
+    // replan below would otherwise ignore their runways
+    promoteToInProgress(currentTime);
+    for (int flightID : unsatisfiedFlights) {
+        int slot = flights.find(flightID);
+        flights.durations[slot] = draw(flightID, flights.durations[slot]);
+    }
+    planValid = false;
+    replanDirty();
+    updatedETAs.clear();
+}
+
+// Run one decoded input command
+void Scheduler::execute(const Command& command, OutputSink& output) {
+    STATS_TIMER(stats.commands[command.type]);
+    const int* args = command.args;
+    int argCount = command.argCount;
+    
+    switch (command.type) {
+    case CMD_INITIALIZE:
+        if (argCount >= 1) {
+            initialize(args[0], output);
+        }
+        break;
+    case CMD_SUBMIT_FLIGHT:
+        if (argCount >= 5) {
+            submitFlight(args[0], args[1], args[2], args[3], args[4], output);
+        }
+        break;
+    case CMD_CANCEL_FLIGHT:
+        if (argCount >= 2) {
+            cancelFlight(args[0], args[1], output);
+        }
+        break;
+    case CMD_REPRIORITIZE:
+        if (argCount >= 3) {
+            reprioritize(args[0], args[1], args[2], output);
+        }
+        break;
+    case CMD_ADD_RUNWAYS:
+        if (argCount >= 2) {
+            addRunways(args[0], args[1], output);
+        }
+        break;
+    case CMD_GROUND_HOLD:
+        if (argCount >= 3) {
+            groundHold(args[0], args[1], args[2], output);
+        }
+        break;
+    case CMD_PRINT_ACTIVE:
+        printActive(output);
+        break;
+    case CMD_PRINT_SCHEDULE:
+        if (argCount >= 2) {
+            printSchedule(args[0], args[1], output);
+        }
+        break;
+    case CMD_TICK:
+        if (argCount >= 1) {
+            tick(args[0], output);
+        }
+        break;
+    case CMD_QUIT:
+        output << "Program Terminated!!";
+        output.endl();
+        break;
+    case CMD_STATS:
+        printStats(output);
+        break;
+    case CMD_SNAPSHOT:
+    case CMD_RESTORE:
+    case CMD_SIMULATE:
+    case CMD_COMMIT:
+    case CMD_DISCARD:
+    case CMD_DELAY_ESTIMATE:
+        // Snapshots, what-if branches and delay estimates cover every
+        // runway group, so RunwayGroups handles them
+    case CMD_UNKNOWN:
+        break;
+    }
+}
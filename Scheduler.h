@@ -2,63 +2,240 @@
 #define SCHEDULER_H
 
 #include "Flight.h"
-#include "PairingHeap.h"
-#include "MinHeap.h"
+#include "FlightTable.h"
+#include "Runway.h"
+#include "QueuePolicy.h"
+#include "OutputSink.h"
+#include "PersistentSet.h"
+#ifdef SCHEDULER_STATS
+#include "SchedulerStats.h"
+#endif
+#include <cstdint>
+#include <map>
+#include <memory>
 #include <unordered_map>
 #include <unordered_set>
+#include <deque>
+#include <functional>
+#include <set>
 #include <vector>
 #include <string>
 
+struct Command;
+class SnapshotWriter;
+class SnapshotReader;
+
+// Orders flight records by flightID
+struct FlightIDLess {
+    bool operator()(const Flight& a, const Flight& b) const {
+        return a.flightID < b.flightID;
+    }
+};
+
+// Versioned copies of what printActive and printSchedule read (ScheduleView)
+typedef PersistentSet<Flight, FlightIDLess> ActiveSet;
+typedef PersistentSet<std::pair<int, int>> ScheduledSet;
+
 class Scheduler {
 private:
     int currentTime;
     int nextRunwayID;
     
     // Data structures
-    PairingHeap pendingFlights;
-    MinHeap<Runway> runwayPool;
-    std::unordered_map<int, Flight> activeFlights;
-    MinHeap<TimetableEntry> timetable;
-    std::unordered_map<int, std::unordered_set<int>> airlineIndex;
+    PendingQueue pendingFlights;
+    RunwayQueue<Runway> runwayPool;
+    FlightTable flights;
+    TimeQueue<TimetableEntry> timetable;
+    // Scheduled flights ordered by start time, popped when they depart
+    TimeQueue<StartEntry> startQueue;
+    // (ETA, flightID) of every flight not yet in progress that has an ETA
+    std::set<std::pair<int, int>> etaIndex;
+    // Flights not yet in progress (PENDING or SCHEDULED)
+    std::unordered_set<int> unsatisfiedFlights;
+    // Flights per airline, ordered by airlineID for range holds
+    std::map<int, std::unordered_set<int>> airlineIndex;
+    // Latest ETA of in-progress flights per runway (-1 when idle)
+    std::vector<int> runwayBusyUntil;
+    
+    // Incremental replanning state
+    // Flights still waiting to start on each runway, in greedy order
+    std::vector<std::deque<int>> runwayPlans;
+    // Handles of flights queued in pendingFlights (state PENDING)
+    std::unordered_map<int, PendingQueue::Handle> pendingNodes;
+    // False when the plan no longer matches a greedy pass (forces full replan)
+    bool planValid;
+    // True when a mutation since the last replan set dirtyKey
+    bool planDirty;
+    // New runways were added; every runway's plan is replanned from its start
+    bool replanAll;
+    // Earliest greedy position touched since the last replan (if planDirty)
+    PlanKey dirtyKey;
+    // A replan started flights at currentTime that are not yet promoted
+    bool startedUnpromoted;
+    // (flightID, new ETA) of flights the last replan moved
+    std::vector<std::pair<int, int>> updatedETAs;
+    // Landings not yet reported, in (ETA, flightID) order per advance
+    std::vector<TimetableEntry> landedFlights;
+    // printActive sort buffers
+    std::vector<uint64_t> printOrder;
+    std::vector<uint64_t> printScratch;
+    // printSchedule result buffer
+    std::vector<std::pair<int, int>> scheduleBuffer;
+    
+    // Published-view state, kept once refreshView() has first been called
+    bool viewTracked;
+    // Flights whose row may have changed since the last refreshView
+    std::vector<int> viewTouched;
+    // Active flights and listed (ETA, flightID) as of the last refreshView
+    ActiveSet viewActive;
+    ScheduledSet viewScheduled;
+    
+#ifdef SCHEDULER_STATS
+    SchedulerStats stats;
+#endif
     
     // Helper methods
     // Process completed flights
-    void settleCompletions(int time, std::vector<std::string>& output);
+    void settleCompletions(int time);
     // Transition scheduled flights to in-progress
     void promoteToInProgress(int time);
     // Reschedule unsatisfied flights
-    void rescheduleUnsatisfied(std::vector<std::string>& output);
+    void rescheduleUnsatisfied(OutputSink& output);
+    // Replan without reporting
+    void replanDirty();
+    // Print and clear the collected ETA changes
+    void reportUpdatedETAs(OutputSink& output);
+    // Print and clear collected landings, then ETA changes
+    void reportEvents(OutputSink& output);
     // Advance scheduler time and process events
-    void advanceTime(int time, std::vector<std::string>& output);
-    // Get list of unsatisfied flights
+    void advanceTime(int time, OutputSink& output);
+    // Get slots of unsatisfied flights
     std::vector<int> getUnsatisfiedFlights();
     // Remove flight from all data structures
     void removeFlightFromStructures(int flightID);
+    // Erase a flight from the flight table
+    void eraseFlight(int slot);
+    // Note a flight whose row changed, for the next refreshView
+    void touchView(int flightID) {
+        if (viewTracked) viewTouched.push_back(flightID);
+    }
+    // Whether printSchedule lists the flight in slot
+    bool listed(int slot) const;
+    // Earliest time a runway can take a new flight
+    int runwayFreeAt(int runwayID) const;
+    // Record that the greedy order changed at or after key
+    void markDirty(const PlanKey& key);
+    // First plan entry that does not precede key
+    std::deque<int>::iterator planLowerBound(std::deque<int>& plan, const PlanKey& key);
+    // Take a scheduled flight off its runway plan
+    void detachFromPlan(int slot);
+    // Remove a started or landed flight from its runway plan
+    void dropFromPlan(int runwayID, int flightID);
+    // Replan every unsatisfied flight from scratch
+    void replanAllFlights();
+    // Replan only the suffix of the greedy order at or after dirtyKey
+    void replanSuffix();
+    // Queue a flight for runway assignment
+    void enqueuePending(int slot);
+    // Greedily assign queued flights against the current runway pool
+    void assignGreedy();
+    // Member-wise copies; fork() and copyFrom() rebuild the pending-heap
+    // handles
+    Scheduler(const Scheduler&) = default;
+    Scheduler& operator=(const Scheduler&) = default;
+    // Point pendingNodes at this scheduler's own heap nodes
+    void collectPendingHandles();
     
 public:
     Scheduler();
     
     // Initialize scheduler with runway count
-    void initialize(int runwayCount, std::vector<std::string>& output);
+    void initialize(int runwayCount, OutputSink& output);
 
     void submitFlight(int flightID, int airlineID, int submitTime, 
-                     int priority, int duration, std::vector<std::string>& output);
+                     int priority, int duration, OutputSink& output);
 
-    void cancelFlight(int flightID, int time, std::vector<std::string>& output);
+    void cancelFlight(int flightID, int time, OutputSink& output);
 
     void reprioritize(int flightID, int time, int newPriority, 
-                     std::vector<std::string>& output);
+                     OutputSink& output);
 
-    void addRunways(int count, int time, std::vector<std::string>& output);
+    void addRunways(int count, int time, OutputSink& output);
     // Ground flights for airline range
     void groundHold(int airlineLow, int airlineHigh, int time, 
-                   std::vector<std::string>& output);
+                   OutputSink& output);
     // Print all active flights
-    void printActive(std::vector<std::string>& output);
+    void printActive(OutputSink& output);
     // Print scheduled flights in time range
-    void printSchedule(int t1, int t2, std::vector<std::string>& output);
+    void printSchedule(int t1, int t2, OutputSink& output);
     // Advance time and process events
-    void tick(int time, std::vector<std::string>& output);
+    void tick(int time, OutputSink& output);
+    // Print instrumentation counters (builds with SCHEDULER_STATS)
+    void printStats(OutputSink& output);
+    // Run one decoded input command
+    void execute(const Command& command, OutputSink& output);
+    
+    // Building blocks for driving several schedulers as one (RunwayGroups).
+    // The command bodies below act at currentTime; callers advance first.
+    // Advance to time, collecting landings and ETA changes without printing
+    void advanceSilently(int time);
+    // Replan after groundAirlines, collecting ETA changes
+    void replanSilently() { replanDirty(); }
+    // Move collected landings and ETA changes into the given vectors
+    void takeEvents(std::vector<TimetableEntry>& landed, 
+                    std::vector<std::pair<int, int>>& updated);
+    // Insert a submitted flight and report its ETA
+    void admitFlight(const Flight& request, OutputSink& output);
+    // Cancel a flight
+    void withdrawFlight(int flightID, OutputSink& output);
+    // Change a flight's priority
+    void changePriority(int flightID, int newPriority, OutputSink& output);
+    // Add runways
+    void openRunways(int count, OutputSink& output);
+    // Remove not-yet-started flights of airlines in range, without replanning
+    void groundAirlines(int airlineLow, int airlineHigh);
+    // Check if a flight is active
+    bool hasFlight(int flightID) const { return flights.find(flightID) != -1; }
+    // ETA of an active flight (-1 for unknown flights)
+    int flightETA(int flightID) const {
+        int slot = flights.find(flightID);
+        return slot == -1 ? -1 : flights.ETAs[slot];
+    }
+    // Append every active flight
+    void collectActive(std::vector<Flight>& out) const;
+    // Append (ETA, flightID) of flights printSchedule would list, in order
+    void collectScheduled(int t1, int t2, std::vector<std::pair<int, int>>& out) const;
+    // Bring activeView() and scheduledView() up to date. Only flights
+    // touched since the last call are revisited, each in O(log n); the
+    // first call builds both sets from scratch.
+    void refreshView();
+    // Active flights by flightID, as of the last refreshView
+    const ActiveSet& activeView() const { return viewActive; }
+    // (ETA, flightID) printSchedule would list, as of the last refreshView
+    const ScheduledSet& scheduledView() const { return viewScheduled; }
+    
+    // Append currentTime, runways and flights to a snapshot image
+    void saveState(SnapshotWriter& writer) const;
+    // Load state written by saveState into a fresh scheduler and rebuild
+    // its indexes; returns false on a malformed image
+    bool loadState(SnapshotReader& reader);
+    // Independent copy of the whole state, plans included, for what-if
+    // branches; unlike a snapshot round trip nothing is rebuilt or replanned
+    std::unique_ptr<Scheduler> fork() const;
+    // Become a copy of other, reusing this scheduler's storage: the pending
+    // heap's node arena and the containers' capacity and nodes
+    void copyFrom(const Scheduler& other);
+    // Give every flight not yet started the duration draw(flightID,
+    // duration) and replan them all from scratch, without reporting
+    void redrawDurations(const std::function<int(int, int)>& draw);
+    
+    // Shared output formats
+    static void printLanded(const std::vector<TimetableEntry>& landed, OutputSink& output);
+    static void printUpdatedETAs(std::vector<std::pair<int, int>>& changes, 
+                                 OutputSink& output);
+    static void printActiveLine(const Flight& flight, OutputSink& output);
+    static void printScheduleLines(const std::vector<std::pair<int, int>>& scheduled, 
+                                   OutputSink& output);
 };
 
 #endif // SCHEDULER_H
\ No newline at end of file
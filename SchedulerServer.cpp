@@ -0,0 +1,345 @@
+#include "SchedulerServer.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+// A line longer than this without a newline drops the client
+const size_t MAX_LINE = 1 << 16;
+const int MAX_EVENTS = 256;
+
+void setNonBlocking(int fd) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+}
+
+} // namespace
+
+SchedulerServer::SchedulerServer(RunwayGroups& s, const LoopOptions& options,
+                                 int readerThreads)
+    : scheduler(s), runner(s, options, replies),
+      listenFd(-1), epollFd(-1), stopFd(-1), readersStopping(false), answerFd(-1) {
+    if (readerThreads > 0) {
+        answerFd = ::eventfd(0, EFD_NONBLOCK);
+    }
+    for (int i = 0; i < readerThreads; i++) {
+        readers.push_back(std::thread(&SchedulerServer::readerLoop, this));
+    }
+}
+
+SchedulerServer::~SchedulerServer() {
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        readersStopping = true;
+    }
+    jobReady.notify_all();
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+    if (answerFd >= 0) ::close(answerFd);
+    
+    for (auto& entry : clients) {
+        ::close(entry.first);
+    }
+    if (listenFd >= 0) {
+        ::close(listenFd);
+        ::unlink(socketPath.c_str());
+    }
+    if (epollFd >= 0) ::close(epollFd);
+    if (stopFd >= 0) ::close(stopFd);
+}
+
+// Bind and listen on path, replacing a stale socket file
+bool SchedulerServer::listen(const std::string& path) {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) return false;
+    std::memcpy(address.sun_path, path.c_str(), path.size());
+    
+    listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0) return false;
+    ::unlink(path.c_str());
+    if (::bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listenFd, SOMAXCONN) != 0) {
+        return false;
+    }
+    socketPath = path;
+    setNonBlocking(listenFd);
+    
+    epollFd = ::epoll_create1(0);
+    stopFd = ::eventfd(0, EFD_NONBLOCK);
+    if (epollFd < 0 || stopFd < 0) return false;
+    
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.fd = listenFd;
+    ::epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event);
+    event.data.fd = stopFd;
+    ::epoll_ctl(epollFd, EPOLL_CTL_ADD, stopFd, &event);
+    if (answerFd >= 0) {
+        event.data.fd = answerFd;
+        ::epoll_ctl(epollFd, EPOLL_CTL_ADD, answerFd, &event);
+    }
+    return true;
+}
+
+// Ask run() to return
+void SchedulerServer::requestStop() {
+    uint64_t one = 1;
+    ssize_t ignored = ::write(stopFd, &one, sizeof(one));
+    (void)ignored;
+}
+
+// One round: read and run everything ready, sync the journal, then reply
+void SchedulerServer::run() {
+    epoll_event events[MAX_EVENTS];
+    std::vector<int> touched;
+    bool stopping = false;
+    
+    while (!stopping) {
+        int ready = ::epoll_wait(epollFd, events, MAX_EVENTS, -1);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        
+        touched.clear();
+        for (int i = 0; i < ready; i++) {
+            int fd = events[i].data.fd;
+            if (fd == stopFd) {
+                stopping = true;
+            } else if (fd == listenFd) {
+                acceptClients();
+            } else if (fd == answerFd) {
+                collectAnswers(touched);
+            } else {
+                auto it = clients.find(fd);
+                if (it == clients.end()) continue;
+                if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                    readClient(fd, it->second);
+                }
+                touched.push_back(fd);
+            }
+        }
+        
+        runner.sync();
+        
+        for (int fd : touched) {
+            auto it = clients.find(fd);
+            if (it == clients.end()) continue;
+            if (!writeClient(fd, it->second)) {
+                dropClient(fd);
+            } else {
+                watch(fd, it->second);
+            }
+        }
+    }
+}
+
+// Accept every pending connection
+void SchedulerServer::acceptClients() {
+    while (true) {
+        int fd = ::accept(listenFd, nullptr, nullptr);
+        if (fd < 0) return;
+        setNonBlocking(fd);
+        
+        epoll_event event;
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        ::epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
+        clients[fd] = Client();
+    }
+}
+
+// Read what a client sent and run its complete lines
+void SchedulerServer::readClient(int fd, Client& client) {
+    char buffer[1 << 16];
+    while (!client.closing) {
+        ssize_t n = ::read(fd, buffer, sizeof(buffer));
+        if (n > 0) {
+            client.input.append(buffer, n);
+            continue;
+        }
+        if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+            // Peer closed: its last line needs no newline
+            client.closing = true;
+            if (!client.input.empty() && client.input.back() != '\n') {
+                client.input += '\n';
+            }
+        }
+        if (n < 0 && errno == EINTR) continue;
+        break;
+    }
+    
+    size_t end = client.input.rfind('\n');
+    if (end != std::string::npos) {
+        const char* begin = client.input.data();
+        CommandReader reader(begin, begin + end + 1);
+        Command command;
+        while (reader.next(command)) {
+            runCommand(command, fd, client);
+            if (command.stop) {
+                client.closing = true;
+                break;
+            }
+        }
+        client.input.erase(0, end + 1);
+    }
+    
+    if (client.input.size() > MAX_LINE) {
+        client.closing = true;
+        client.input.clear();
+    }
+}
+
+// Run one command and queue its output and the empty end line
+void SchedulerServer::runCommand(const Command& command, int clientFd, Client& client) {
+    // Queries change nothing, so they skip the runner and its journal
+    if (!readers.empty() && ScheduleView::answers(command)) {
+        // Publishing after the client's earlier commands keeps its own
+        // writes visible to the query
+        scheduler.publishView();
+        std::shared_ptr<QueryJob> job = std::make_shared<QueryJob>();
+        job->fd = clientFd;
+        job->command = command;
+        job->view = scheduler.view();
+        Waiting waiting;
+        waiting.job = job;
+        client.waiting.push_back(waiting);
+        {
+            std::lock_guard<std::mutex> lock(jobMutex);
+            jobs.push_back(job);
+        }
+        jobReady.notify_one();
+        return;
+    }
+    
+    runner.run(command);
+    queue(client, replies.str() + '\n');
+    replies.clear();
+}
+
+// Output goes after the last unanswered query, if any
+void SchedulerServer::queue(Client& client, const std::string& text) {
+    if (client.waiting.empty()) {
+        client.output += text;
+    } else {
+        client.waiting.back().after += text;
+    }
+}
+
+// Answer queued queries from their views
+void SchedulerServer::readerLoop() {
+    StringSink reply;
+    while (true) {
+        std::shared_ptr<QueryJob> job;
+        {
+            std::unique_lock<std::mutex> lock(jobMutex);
+            jobReady.wait(lock, [this] { return readersStopping || !jobs.empty(); });
+            if (readersStopping) return;
+            job = jobs.front();
+            jobs.pop_front();
+        }
+        
+        job->view->execute(job->command, reply);
+        job->reply = reply.str();
+        job->reply += '\n';
+        reply.clear();
+        job->done.store(true, std::memory_order_release);
+        
+        {
+            std::lock_guard<std::mutex> lock(jobMutex);
+            answered.push_back(job->fd);
+        }
+        uint64_t one = 1;
+        ssize_t ignored = ::write(answerFd, &one, sizeof(one));
+        (void)ignored;
+    }
+}
+
+// Release each answered client's output up to its next unanswered query.
+// The loop then sends it, and drops a closing client once nothing is left.
+void SchedulerServer::collectAnswers(std::vector<int>& touched) {
+    uint64_t count;
+    ssize_t ignored = ::read(answerFd, &count, sizeof(count));
+    (void)ignored;
+    
+    std::vector<int> fds;
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        fds.swap(answered);
+    }
+    
+    for (int fd : fds) {
+        auto it = clients.find(fd);
+        if (it == clients.end()) continue;
+        Client& client = it->second;
+        while (!client.waiting.empty() &&
+               client.waiting.front().job->done.load(std::memory_order_acquire)) {
+            client.output += client.waiting.front().job->reply;
+            client.output += client.waiting.front().after;
+            client.waiting.pop_front();
+        }
+        touched.push_back(fd);
+    }
+}
+
+// Send as much queued output as the socket takes
+bool SchedulerServer::writeClient(int fd, Client& client) {
+    while (client.sent < client.output.size()) {
+        ssize_t n = ::send(fd, client.output.data() + client.sent,
+                           client.output.size() - client.sent, MSG_NOSIGNAL);
+        if (n > 0) {
+            client.sent += n;
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return true;
+        } else {
+            return false;
+        }
+    }
+    
+    client.output.clear();
+    client.sent = 0;
+    // A closing client stays until its queries are answered
+    return !client.closing || !client.waiting.empty();
+}
+
+// Watch for input until closing, and for output space only while output
+// is queued. A closing client with nothing to send is taken off epoll
+// until collectAnswers hands it output.
+void SchedulerServer::watch(int fd, Client& client) {
+    epoll_event event;
+    event.events = client.closing ? 0u : (uint32_t)EPOLLIN;
+    if (!client.output.empty()) {
+        event.events |= EPOLLOUT;
+    }
+    event.data.fd = fd;
+    
+    if (event.events == 0) {
+        if (client.polled) {
+            ::epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+            client.polled = false;
+        }
+    } else if (client.polled) {
+        ::epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &event);
+    } else {
+        ::epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
+        client.polled = true;
+    }
+}
+
+void SchedulerServer::dropClient(int fd) {
+    if (clients[fd].polled) {
+        ::epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    }
+    ::close(fd);
+    clients.erase(fd);
+}
@@ -0,0 +1,117 @@
+#ifndef SCHEDULER_SERVER_H
+#define SCHEDULER_SERVER_H
+
+#include "CommandLoop.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Long-running scheduler behind a Unix domain socket. Clients send text
+// command lines; each command's output comes back followed by an empty
+// line. One epoll loop serves every client and runs commands one at a
+// time, so a query always sees the state between two whole commands.
+//
+// With a journal, commands are journaled as they run and the records of
+// one loop round are synced together before any of that round's replies
+// are sent.
+//
+// With reader threads, PrintActive and PrintSchedule are answered off the
+// loop from the ScheduleView published after the client's earlier
+// commands; replies still go out in request order.
+class SchedulerServer {
+private:
+    // A query answered by a reader thread
+    struct QueryJob {
+        int fd;
+        Command command;
+        std::shared_ptr<const ScheduleView> view;
+        std::string reply;
+        std::atomic<bool> done;
+        
+        QueryJob() : fd(-1), done(false) {}
+    };
+    
+    // Output held back behind an unanswered query
+    struct Waiting {
+        std::shared_ptr<QueryJob> job;
+        std::string after;
+    };
+    
+    struct Client {
+        std::string input;
+        std::string output;
+        size_t sent;
+        std::deque<Waiting> waiting;
+        // Close once output is sent (after Quit or a protocol error)
+        bool closing;
+        // Registered with epoll; a closed peer waiting only on queries is
+        // not, since its hangup would be reported on every wait
+        bool polled;
+        
+        Client() : sent(0), closing(false), polled(true) {}
+    };
+    
+    RunwayGroups& scheduler;
+    // Reply text of the command being run
+    StringSink replies;
+    // Journals commands and runs them into replies
+    CommandRunner runner;
+    std::string socketPath;
+    int listenFd;
+    int epollFd;
+    // Written to wake the loop for shutdown
+    int stopFd;
+    std::unordered_map<int, Client> clients;
+    
+    // Reader threads and their queue
+    std::vector<std::thread> readers;
+    std::mutex jobMutex;
+    std::condition_variable jobReady;
+    std::deque<std::shared_ptr<QueryJob>> jobs;
+    bool readersStopping;
+    // Clients with newly answered queries, guarded by jobMutex
+    std::vector<int> answered;
+    // Written by readers to wake the loop
+    int answerFd;
+    
+    SchedulerServer(const SchedulerServer&);
+    SchedulerServer& operator=(const SchedulerServer&);
+    
+    // Accept every pending connection
+    void acceptClients();
+    // Read what a client sent and run its complete lines
+    void readClient(int fd, Client& client);
+    // Run one command line and queue its reply
+    void runCommand(const Command& command, int clientFd, Client& client);
+    // Queue output behind any unanswered query
+    void queue(Client& client, const std::string& text);
+    // Reader thread body
+    void readerLoop();
+    // Move finished answers into their clients' output
+    void collectAnswers(std::vector<int>& touched);
+    // Send queued output; returns false if the client should be dropped
+    bool writeClient(int fd, Client& client);
+    // Watch fd for output space only while output is queued
+    void watch(int fd, Client& client);
+    void dropClient(int fd);
+
+public:
+    // readerThreads of 0 answers queries on the loop thread
+    SchedulerServer(RunwayGroups& s, const LoopOptions& options, int readerThreads);
+    ~SchedulerServer();
+    
+    // Bind and listen on path, replacing a stale socket file
+    bool listen(const std::string& path);
+    // Serve clients until requestStop()
+    void run();
+    // Ask run() to return; safe from a signal handler or another thread
+    void requestStop();
+};
+
+#endif // SCHEDULER_SERVER_H
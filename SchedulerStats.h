@@ -0,0 +1,151 @@
+#ifndef SCHEDULER_STATS_H
+#define SCHEDULER_STATS_H
+
+// Optional instrumentation, compiled in with -DSCHEDULER_STATS (make STATS=1).
+// Without it the macros below expand to nothing.
+#ifdef SCHEDULER_STATS
+
+#include "CommandReader.h"
+#include "OutputSink.h"
+#include <chrono>
+#include <cstdint>
+
+// Call count and time spent in one scheduler phase
+struct PhaseTimer {
+    uint64_t calls;
+    uint64_t totalNs;
+    uint64_t maxNs;
+    
+    PhaseTimer() : calls(0), totalNs(0), maxNs(0) {}
+    
+    void add(uint64_t ns) {
+        calls++;
+        totalNs += ns;
+        if (ns > maxNs) maxNs = ns;
+    }
+};
+
+// Latency histogram with power-of-two buckets; bucket b holds [2^(b-1), 2^b) ns
+struct LatencyHistogram {
+    enum { BUCKETS = 64 };
+    
+    uint64_t buckets[BUCKETS];
+    PhaseTimer totals;
+    
+    LatencyHistogram() {
+        for (int b = 0; b < BUCKETS; b++) buckets[b] = 0;
+    }
+    
+    void add(uint64_t ns) {
+        int b = 0;
+        while (b < BUCKETS - 1 && (ns >> b) != 0) b++;
+        buckets[b]++;
+        totals.add(ns);
+    }
+    
+    // Upper bound of the bucket holding quantile q
+    uint64_t quantileBound(double q) const {
+        uint64_t rank = (uint64_t)(q * (totals.calls - 1));
+        uint64_t seen = 0;
+        for (int b = 0; b < BUCKETS; b++) {
+            seen += buckets[b];
+            if (seen > rank) return b == 0 ? 0 : (uint64_t)1 << b;
+        }
+        return totals.maxNs;
+    }
+};
+
+// Times the enclosing scope into a PhaseTimer or LatencyHistogram
+template<typename Sink>
+class ScopedTimer {
+private:
+    Sink& sink;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    explicit ScopedTimer(Sink& s) : sink(s), start(std::chrono::steady_clock::now()) {}
+    
+    ~ScopedTimer() {
+        sink.add((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count());
+    }
+};
+
+// Everything the scheduler records
+struct SchedulerStats {
+    // Phases
+    PhaseTimer settle;
+    PhaseTimer promote;
+    PhaseTimer reschedule;
+    
+    // Counters
+    uint64_t fullReplans;
+    uint64_t suffixReplans;
+    uint64_t flightsReplanned;
+    uint64_t etasUpdated;
+    uint64_t timetableUpdates;
+    uint64_t pendingPops;
+    uint64_t flightsRemoved;
+    uint64_t flightsPromoted;
+    uint64_t flightsLanded;
+    
+    // Per-command latency
+    LatencyHistogram commands[COMMAND_TYPES];
+    
+    SchedulerStats()
+        : fullReplans(0), suffixReplans(0), flightsReplanned(0), etasUpdated(0),
+          timetableUpdates(0), pendingPops(0), flightsRemoved(0), flightsPromoted(0),
+          flightsLanded(0) {}
+    
+    // Print phases, counters and command latencies
+    void print(OutputSink& output) const {
+        printPhase(output, "settleCompletions", settle);
+        printPhase(output, "promoteToInProgress", promote);
+        printPhase(output, "rescheduleUnsatisfied", reschedule);
+        
+        output << "counters fullReplans=" << (long long)fullReplans
+               << " suffixReplans=" << (long long)suffixReplans
+               << " flightsReplanned=" << (long long)flightsReplanned
+               << " etasUpdated=" << (long long)etasUpdated
+               << " timetableUpdates=" << (long long)timetableUpdates
+               << " pendingPops=" << (long long)pendingPops;
+        output.endl();
+        output << "counters flightsRemoved=" << (long long)flightsRemoved
+               << " flightsPromoted=" << (long long)flightsPromoted
+               << " flightsLanded=" << (long long)flightsLanded;
+        output.endl();
+        
+        for (int type = CMD_INITIALIZE; type < COMMAND_TYPES; type++) {
+            const LatencyHistogram& h = commands[type];
+            if (h.totals.calls == 0) continue;
+            output << "command " << commandName((CommandType)type)
+                   << " count=" << (long long)h.totals.calls
+                   << " mean_ns=" << (long long)(h.totals.totalNs / h.totals.calls)
+                   << " p50_ns<=" << (long long)h.quantileBound(0.5)
+                   << " p90_ns<=" << (long long)h.quantileBound(0.9)
+                   << " p99_ns<=" << (long long)h.quantileBound(0.99)
+                   << " max_ns=" << (long long)h.totals.maxNs;
+            output.endl();
+        }
+    }
+
+private:
+    static void printPhase(OutputSink& output, const char* name, const PhaseTimer& t) {
+        output << "phase " << name << " calls=" << (long long)t.calls
+               << " total_ns=" << (long long)t.totalNs
+               << " max_ns=" << (long long)t.maxNs;
+        output.endl();
+    }
+};
+
+#define STATS_TIMER(timer) ScopedTimer<decltype(timer)> statsTimer_(timer)
+#define STATS_ADD(counter, n) (stats.counter += (n))
+
+#else
+
+#define STATS_TIMER(timer)
+#define STATS_ADD(counter, n)
+
+#endif // SCHEDULER_STATS
+
+#endif // SCHEDULER_STATS_H
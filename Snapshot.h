@@ -0,0 +1,136 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+// Snapshot files are a flat sequence of native-endian 32-bit words, so a
+// mapped file is read in place without parsing. Layout (version 1):
+//
+//   header   magic, version, groupCount, generation
+//   group    groupID, currentTime, nextRunwayID, busyCount, flightCount,
+//            runwayBusyUntil[busyCount],
+//            then one column of flightCount words per flight field:
+//            flightID, airlineID, submitTime, priority, duration,
+//            runwayID, startTime, ETA, state
+//
+// Indexes (timetable, departure queue, ETA and airline indexes, runway
+// pool and plans) are rebuilt from the columns on restore. The generation
+// is 0 for Snapshot(path) and numbers journal checkpoints (Journal.h).
+const uint32_t SNAPSHOT_MAGIC = 0x50534147;    // "GASP" read little-endian
+const uint32_t SNAPSHOT_VERSION = 1;
+
+// Builds a snapshot image in memory
+class SnapshotWriter {
+private:
+    std::string bytes;
+
+public:
+    void putWord(uint32_t value) {
+        bytes.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+    
+    void putInt(int value) {
+        putWord((uint32_t)value);
+    }
+    
+    void putInts(const std::vector<int>& values) {
+        if (!values.empty()) {
+            bytes.append(reinterpret_cast<const char*>(values.data()),
+                         values.size() * sizeof(int));
+        }
+    }
+    
+    // Byte column widened to words
+    void putBytes(const std::vector<unsigned char>& values) {
+        for (unsigned char value : values) {
+            putWord(value);
+        }
+    }
+    
+    // Write the image to path through a synced temporary file, so an
+    // existing snapshot is only replaced by a complete one
+    bool writeFile(const std::string& path) const {
+        std::string temporary = path + ".tmp";
+        int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) return false;
+        
+        size_t written = 0;
+        while (written < bytes.size()) {
+            ssize_t n = ::write(fd, bytes.data() + written, bytes.size() - written);
+            if (n <= 0) break;
+            written += n;
+        }
+        bool ok = written == bytes.size() && ::fsync(fd) == 0;
+        ok = ::close(fd) == 0 && ok;
+        
+        if (!ok || std::rename(temporary.c_str(), path.c_str()) != 0) {
+            std::remove(temporary.c_str());
+            return false;
+        }
+        return true;
+    }
+};
+
+// Reads words from a snapshot image; every read fails past the end
+class SnapshotReader {
+private:
+    const char* pos;
+    const char* limit;
+    
+    bool available(size_t words) const {
+        return (size_t)(limit - pos) / sizeof(uint32_t) >= words;
+    }
+
+public:
+    SnapshotReader(const char* begin, const char* end) : pos(begin), limit(end) {}
+    
+    bool getWord(uint32_t& value) {
+        if (!available(1)) return false;
+        std::memcpy(&value, pos, sizeof(value));
+        pos += sizeof(value);
+        return true;
+    }
+    
+    bool getInt(int& value) {
+        uint32_t word;
+        if (!getWord(word)) return false;
+        value = (int)word;
+        return true;
+    }
+    
+    bool getInts(std::vector<int>& values, size_t count) {
+        if (!available(count)) return false;
+        values.resize(count);
+        if (count > 0) {
+            std::memcpy(values.data(), pos, count * sizeof(int));
+        }
+        pos += count * sizeof(int);
+        return true;
+    }
+    
+    // Word column narrowed to bytes
+    bool getBytes(std::vector<unsigned char>& values, size_t count) {
+        if (!available(count)) return false;
+        values.resize(count);
+        for (size_t i = 0; i < count; i++) {
+            uint32_t word = 0;
+            getWord(word);
+            if (word > 0xff) return false;
+            values[i] = (unsigned char)word;
+        }
+        return true;
+    }
+    
+    // Check that the whole image was consumed
+    bool atEnd() const {
+        return pos == limit;
+    }
+};
+
+#endif // SNAPSHOT_H
@@ -0,0 +1,85 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <utility>
+
+// Bounded lock-free queue between exactly one producer thread and one
+// consumer thread. Capacity must be a power of two. The producer calls
+// push() and finally close(); the consumer calls pop() until it returns
+// false. A full or empty ring makes the waiting side yield, not block.
+template<typename T, size_t Capacity>
+class SpscRing {
+private:
+    enum { CACHE_LINE = 64 };
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    
+    T slots[Capacity];
+    
+    // Producer side: next index to write, and the last head it saw
+    alignas(CACHE_LINE) std::atomic<size_t> tail;
+    size_t cachedHead;
+    // Consumer side: next index to read, and the last tail it saw
+    alignas(CACHE_LINE) std::atomic<size_t> head;
+    size_t cachedTail;
+    alignas(CACHE_LINE) std::atomic<bool> closed;
+    
+    SpscRing(const SpscRing&);
+    SpscRing& operator=(const SpscRing&);
+
+public:
+    SpscRing() : tail(0), cachedHead(0), head(0), cachedTail(0), closed(false) {}
+    
+    // Producer: enqueue value unless the ring is full
+    bool tryPush(T& value) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - cachedHead == Capacity) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (t - cachedHead == Capacity) return false;
+        }
+        slots[t & (Capacity - 1)] = std::move(value);
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+    
+    // Producer: enqueue value, waiting for room
+    void push(T& value) {
+        while (!tryPush(value)) {
+            std::this_thread::yield();
+        }
+    }
+    
+    // Producer: no more values will be pushed
+    void close() {
+        closed.store(true, std::memory_order_release);
+    }
+    
+    // Consumer: dequeue into value unless the ring is empty
+    bool tryPop(T& value) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == cachedTail) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (h == cachedTail) return false;
+        }
+        value = std::move(slots[h & (Capacity - 1)]);
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+    
+    // Consumer: dequeue into value, waiting for one; false once the ring
+    // is closed and drained
+    bool pop(T& value) {
+        while (!tryPop(value)) {
+            // Values pushed before close() are visible once closed is
+            if (closed.load(std::memory_order_acquire)) {
+                return tryPop(value);
+            }
+            std::this_thread::yield();
+        }
+        return true;
+    }
+};
+
+#endif // SPSC_RING_H
@@ -0,0 +1,117 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads that run one indexed batch of tasks at a time.
+// The calling thread takes part, so a pool of N threads starts N - 1 workers.
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    
+    // Current batch. task and taskCount only change while no worker is
+    // inside work(), which the active count guards.
+    const std::function<void(size_t)>* task;
+    size_t taskCount;
+    std::atomic<size_t> next;
+    size_t finished;
+    int active;
+    unsigned generation;
+    bool stopping;
+    
+    // Claim and run tasks until the batch is exhausted; returns how many ran
+    size_t work() {
+        size_t completed = 0;
+        while (true) {
+            size_t i = next.fetch_add(1);
+            if (i >= taskCount) break;
+            (*task)(i);
+            completed++;
+        }
+        return completed;
+    }
+    
+    // Worker thread body: wait for a new batch, help run it
+    void workerLoop() {
+        unsigned seen = 0;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait(lock, [this, seen] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+            active++;
+            
+            lock.unlock();
+            size_t completed = work();
+            lock.lock();
+            
+            active--;
+            finished += completed;
+            done.notify_all();
+        }
+    }
+    
+    ThreadPool(const ThreadPool&);
+    ThreadPool& operator=(const ThreadPool&);
+
+public:
+    explicit ThreadPool(int threads)
+        : task(nullptr), taskCount(0), next(0), finished(0), active(0), generation(0), 
+          stopping(false) {
+        for (int i = 1; i < threads; i++) {
+            workers.push_back(std::thread(&ThreadPool::workerLoop, this));
+        }
+    }
+    
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
+    
+    // Number of threads that run tasks, including the caller
+    int threads() const {
+        return (int)workers.size() + 1;
+    }
+    
+    // Run fn(0) .. fn(count - 1) across the pool and wait for all of them
+    void run(size_t count, const std::function<void(size_t)>& fn) {
+        if (workers.empty() || count <= 1) {
+            for (size_t i = 0; i < count; i++) fn(i);
+            return;
+        }
+        
+        {
+            // Late wakers from the previous batch must leave work() first
+            std::unique_lock<std::mutex> lock(mutex);
+            done.wait(lock, [this] { return active == 0; });
+            task = &fn;
+            taskCount = count;
+            finished = 0;
+            next.store(0);
+            generation++;
+        }
+        wake.notify_all();
+        
+        size_t completed = work();
+        
+        std::unique_lock<std::mutex> lock(mutex);
+        finished += completed;
+        done.wait(lock, [this] { return finished == taskCount && active == 0; });
+    }
+};
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,80 @@
+// Monte Carlo delay simulation throughput for 1..N threads, on the state a
+// generated workload leaves behind (few runways, so a backlog of flights
+// waits to start), followed by sample per-flight ETA percentiles
+#include "CommandReader.h"
+#include "DelaySimulation.h"
+#include "Workload.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+typedef std::chrono::steady_clock Clock;
+
+int main(int argc, char* argv[]) {
+    WorkloadConfig config;
+    config.flights = 5000;
+    config.runways = 4;
+    int trials = 1000;
+    double sigma = 0.3;
+    int maxThreads = 8;
+    
+    for (int i = 1; i < argc; i++) {
+        if (std::strncmp(argv[i], "--trials=", 9) == 0) {
+            trials = std::max(1, std::atoi(argv[i] + 9));
+        } else if (std::strncmp(argv[i], "--sigma=", 8) == 0) {
+            sigma = std::atof(argv[i] + 8);
+        } else if (std::strncmp(argv[i], "--max-threads=", 14) == 0) {
+            maxThreads = std::max(1, std::atoi(argv[i] + 14));
+        } else if (!config.parseOption(argv[i])) {
+            std::fprintf(stderr, "Usage: %s [--trials=N] [--sigma=S] [--max-threads=N] "
+                         "[options]\n%s", argv[0], WORKLOAD_OPTIONS);
+            return 1;
+        }
+    }
+    
+    std::string text;
+    WorkloadGenerator(config).generate(text);
+    Scheduler scheduler;
+    DiscardSink discard;
+    CommandReader reader(text.data(), text.data() + text.size());
+    Command command;
+    while (reader.next(command)) {
+        scheduler.execute(command, discard);
+    }
+    
+    std::printf("%d trials, sigma %.2f\n", trials, sigma);
+    std::printf("%8s %8s %10s %10s %12s %8s\n", "threads", "flights", "first ms", "ms",
+                "trials/s", "speedup");
+    
+    // The first run grows each replica's storage; the second reuses it
+    double baseRate = 0;
+    std::vector<EtaPercentiles> results;
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        ThreadPool pool(threads);
+        DelaySimulation simulation(pool);
+        auto start = Clock::now();
+        simulation.run(scheduler, trials, sigma, 1);
+        double firstMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        start = Clock::now();
+        simulation.run(scheduler, trials, sigma, 1);
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        
+        double rate = trials / (ms / 1000);
+        if (threads == 1) baseRate = rate;
+        std::printf("%8d %8zu %10.1f %10.1f %12.1f %8.2f\n", threads, simulation.flightCount(),
+                    firstMs, ms, rate, rate / baseRate);
+        simulation.percentiles(results);
+    }
+    
+    // A few flights spread through the planned order
+    StringSink sample;
+    std::vector<EtaPercentiles> picked;
+    for (size_t i = 0; i < 5 && !results.empty(); i++) {
+        picked.push_back(results[i * (results.size() - 1) / 4]);
+    }
+    DelaySimulation::print(picked, sample);
+    std::printf("%s", sample.str().c_str());
+    return 0;
+}
@@ -0,0 +1,37 @@
+// Write a synthetic scheduler input file
+#include "Workload.h"
+#include <cstdio>
+#include <string>
+
+int main(int argc, char* argv[]) {
+    WorkloadConfig config;
+    const char* path = nullptr;
+    
+    for (int i = 1; i < argc; i++) {
+        if (argv[i][0] != '-') {
+            path = argv[i];
+        } else if (!config.parseOption(argv[i])) {
+            std::fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            path = nullptr;
+            break;
+        }
+    }
+    
+    if (!path) {
+        std::fprintf(stderr, "Usage: %s [options] <output_file>\n%s", argv[0], WORKLOAD_OPTIONS);
+        return 1;
+    }
+    
+    std::string text;
+    WorkloadGenerator(config).generate(text);
+    
+    std::FILE* file = std::fopen(path, "w");
+    if (!file) {
+        std::perror(path);
+        return 1;
+    }
+    std::fwrite(text.data(), 1, text.size(), file);
+    std::fclose(file);
+    
+    return 0;
+}
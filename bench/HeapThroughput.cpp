@@ -0,0 +1,197 @@
+// Pending-queue microbenchmark: PairingHeap against the previous
+// allocation-per-node implementation, std::priority_queue and MinHeap
+#include "PairingHeap.h"
+#include "MinHeap.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <queue>
+#include <vector>
+
+// Pairing heap as it was before the node arena: new/delete per node and a
+// scratch vector in every mergePairs
+struct LegacyNode {
+    int priority;
+    int negSubmitTime;
+    int negFlightID;
+    Flight* flight;
+    LegacyNode* leftChild;
+    LegacyNode* nextSibling;
+    
+    LegacyNode(Flight* f) 
+        : priority(f->priority), negSubmitTime(-f->submitTime), negFlightID(-f->flightID),
+          flight(f), leftChild(nullptr), nextSibling(nullptr) {}
+    
+    bool operator>(const LegacyNode& other) const {
+        if (priority != other.priority) return priority > other.priority;
+        if (negSubmitTime != other.negSubmitTime) return negSubmitTime > other.negSubmitTime;
+        return negFlightID > other.negFlightID;
+    }
+};
+
+class LegacyPairingHeap {
+private:
+    LegacyNode* root;
+    
+    LegacyNode* merge(LegacyNode* h1, LegacyNode* h2) {
+        if (!h1) return h2;
+        if (!h2) return h1;
+        if (*h1 > *h2) {
+            h2->nextSibling = h1->leftChild;
+            h1->leftChild = h2;
+            return h1;
+        }
+        h1->nextSibling = h2->leftChild;
+        h2->leftChild = h1;
+        return h2;
+    }
+    
+    LegacyNode* mergePairs(LegacyNode* node) {
+        if (!node || !node->nextSibling) return node;
+        std::vector<LegacyNode*> trees;
+        while (node) {
+            LegacyNode* first = node;
+            LegacyNode* second = node->nextSibling;
+            if (second) {
+                node = second->nextSibling;
+                first->nextSibling = nullptr;
+                second->nextSibling = nullptr;
+                trees.push_back(merge(first, second));
+            } else {
+                node = nullptr;
+                trees.push_back(first);
+            }
+        }
+        LegacyNode* result = trees.back();
+        for (int i = trees.size() - 2; i >= 0; i--) {
+            result = merge(trees[i], result);
+        }
+        return result;
+    }
+
+public:
+    LegacyPairingHeap() : root(nullptr) {}
+    
+    void push(Flight* flight) { root = merge(root, new LegacyNode(flight)); }
+    Flight* top() { return root ? root->flight : nullptr; }
+    void pop() {
+        LegacyNode* oldRoot = root;
+        root = mergePairs(root->leftChild);
+        delete oldRoot;
+    }
+    bool empty() const { return root == nullptr; }
+};
+
+// Greedy order as a plain value; "less" means assigned first
+struct HeapKey {
+    int priority;
+    int submitTime;
+    int flightID;
+    
+    HeapKey(const Flight& f) 
+        : priority(f.priority), submitTime(f.submitTime), flightID(f.flightID) {}
+    
+    bool operator<(const HeapKey& other) const {
+        if (priority != other.priority) return priority > other.priority;
+        if (submitTime != other.submitTime) return submitTime < other.submitTime;
+        return flightID < other.flightID;
+    }
+    
+    bool operator>(const HeapKey& other) const {
+        return other < *this;
+    }
+};
+
+typedef std::priority_queue<HeapKey, std::vector<HeapKey>, std::greater<HeapKey>> StdQueue;
+
+// Adapters so every queue runs the same loops; flight i is in slot i - 1
+static void pushFlight(PairingHeap& h, Flight& f) { h.push(PlanKey(f), f.flightID - 1); }
+static void pushFlight(LegacyPairingHeap& h, Flight& f) { h.push(&f); }
+static void pushFlight(StdQueue& h, Flight& f) { h.push(HeapKey(f)); }
+static void pushFlight(MinHeap<HeapKey>& h, Flight& f) { h.push(HeapKey(f)); }
+
+static int topID(PairingHeap& h) { return h.top() + 1; }
+static int topID(LegacyPairingHeap& h) { return h.top()->flightID; }
+static int topID(StdQueue& h) { return h.top().flightID; }
+static int topID(MinHeap<HeapKey>& h) { return h.top().flightID; }
+
+static double seconds(std::chrono::steady_clock::time_point begin) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+// Push every flight, then drain; repeated rounds reuse the same queue
+template<typename Queue>
+void runDrain(const char* name, std::vector<Flight>& flights, int rounds) {
+    Queue queue;
+    long checksum = 0;
+    double pushTime = 0, popTime = 0;
+    
+    for (int r = 0; r < rounds; r++) {
+        auto begin = std::chrono::steady_clock::now();
+        for (Flight& f : flights) pushFlight(queue, f);
+        pushTime += seconds(begin);
+        
+        begin = std::chrono::steady_clock::now();
+        while (!queue.empty()) {
+            checksum += topID(queue);
+            queue.pop();
+        }
+        popTime += seconds(begin);
+    }
+    
+    double ops = (double)flights.size() * rounds;
+    std::printf("%-16s %12.2f %12.2f %12ld\n", name, 
+                ops / pushTime / 1e6, ops / popTime / 1e6, checksum);
+}
+
+// Steady-state queue of half the flights with interleaved push/pop
+template<typename Queue>
+void runMixed(const char* name, std::vector<Flight>& flights, int rounds) {
+    Queue queue;
+    size_t half = flights.size() / 2;
+    for (size_t i = 0; i < half; i++) pushFlight(queue, flights[i]);
+    
+    long checksum = 0;
+    auto begin = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (size_t i = half; i < flights.size(); i++) {
+            pushFlight(queue, flights[i]);
+            checksum += topID(queue);
+            queue.pop();
+        }
+    }
+    double elapsed = seconds(begin);
+    
+    double ops = (double)(flights.size() - half) * rounds;
+    std::printf("%-16s %12.2f %12ld\n", name, ops / elapsed / 1e6, checksum);
+}
+
+int main(int argc, char* argv[]) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 100000;
+    int rounds = argc > 2 ? std::atoi(argv[2]) : 5;
+    
+    std::vector<Flight> flights;
+    flights.reserve(count);
+    unsigned seed = 2024;
+    for (int i = 0; i < count; i++) {
+        seed = seed * 1103515245 + 12345;
+        flights.push_back(Flight(i + 1, (seed >> 8) % 100, (seed >> 4) % 1000, 
+                                 (seed >> 16) % 10, 1 + (seed >> 12) % 30));
+    }
+    
+    std::printf("%d flights, %d rounds\n\n", count, rounds);
+    std::printf("%-16s %12s %12s %12s\n", "drain", "push Mops/s", "pop Mops/s", "checksum");
+    runDrain<PairingHeap>("PairingHeap", flights, rounds);
+    runDrain<LegacyPairingHeap>("legacy pairing", flights, rounds);
+    runDrain<StdQueue>("priority_queue", flights, rounds);
+    runDrain<MinHeap<HeapKey>>("MinHeap", flights, rounds);
+    
+    std::printf("\n%-16s %12s %12s\n", "push+pop", "Mops/s", "checksum");
+    runMixed<PairingHeap>("PairingHeap", flights, rounds);
+    runMixed<LegacyPairingHeap>("legacy pairing", flights, rounds);
+    runMixed<StdQueue>("priority_queue", flights, rounds);
+    runMixed<MinHeap<HeapKey>>("MinHeap", flights, rounds);
+    
+    return 0;
+}
@@ -0,0 +1,187 @@
+// Input parsing throughput: the mmap command reader against the previous
+// getline + stringstream + std::stoi path, and the binary command reader on
+// the same file converted, on a generated command file
+#include "CommandReader.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Write a command mix shaped like a busy input file
+static void generateInput(const char* path, long lines) {
+    std::FILE* file = std::fopen(path, "w");
+    if (!file) {
+        std::perror(path);
+        std::exit(1);
+    }
+    
+    unsigned seed = 12345;
+    int time = 0;
+    int flightID = 1;
+    std::fprintf(file, "Initialize(20)\n");
+    for (long i = 1; i < lines - 1; i++) {
+        seed = seed * 1103515245 + 12345;
+        unsigned r = (seed >> 8) % 100;
+        if (r < 60) {
+            std::fprintf(file, "SubmitFlight(%d, %u, %d, %u, %u)\n", flightID++,
+                         (seed >> 4) % 50, time, (seed >> 12) % 10, 1 + (seed >> 16) % 30);
+        } else if (r < 70) {
+            std::fprintf(file, "CancelFlight(%u, %d)\n", 1 + (seed >> 4) % flightID, time);
+        } else if (r < 80) {
+            std::fprintf(file, "Reprioritize(%u, %d, %u)\n", 1 + (seed >> 4) % flightID,
+                         time, (seed >> 12) % 10);
+        } else if (r < 90) {
+            time += 1 + (seed >> 4) % 3;
+            std::fprintf(file, "Tick(%d)\n", time);
+        } else if (r < 95) {
+            std::fprintf(file, "PrintSchedule(%d, %d)\n", time, time + 50);
+        } else {
+            std::fprintf(file, "PrintActive()\n");
+        }
+    }
+    std::fprintf(file, "Quit()\n");
+    std::fclose(file);
+}
+
+// Parse path as it was before the command reader
+static long legacyParse(const char* path, long& checksum) {
+    std::ifstream input(path);
+    std::string line;
+    long lines = 0;
+    
+    while (std::getline(input, line)) {
+        line.erase(0, line.find_first_not_of(" \t\r\n"));
+        line.erase(line.find_last_not_of(" \t\r\n") + 1);
+        if (line.empty()) continue;
+        
+        size_t openParen = line.find('(');
+        if (openParen == std::string::npos) continue;
+        
+        std::string command = line.substr(0, openParen);
+        size_t closeParen = line.find(')');
+        std::string argsStr = line.substr(openParen + 1, closeParen - openParen - 1);
+        
+        std::vector<int> args;
+        std::stringstream ss(argsStr);
+        std::string token;
+        while (std::getline(ss, token, ',')) {
+            token.erase(0, token.find_first_not_of(" \t"));
+            token.erase(token.find_last_not_of(" \t") + 1);
+            if (!token.empty()) {
+                args.push_back(std::stoi(token));
+            }
+        }
+        
+        int type = CMD_UNKNOWN;
+        if (command == "Initialize") type = CMD_INITIALIZE;
+        else if (command == "SubmitFlight") type = CMD_SUBMIT_FLIGHT;
+        else if (command == "CancelFlight") type = CMD_CANCEL_FLIGHT;
+        else if (command == "Reprioritize") type = CMD_REPRIORITIZE;
+        else if (command == "AddRunways") type = CMD_ADD_RUNWAYS;
+        else if (command == "GroundHold") type = CMD_GROUND_HOLD;
+        else if (command == "PrintActive") type = CMD_PRINT_ACTIVE;
+        else if (command == "PrintSchedule") type = CMD_PRINT_SCHEDULE;
+        else if (command == "Tick") type = CMD_TICK;
+        else if (command == "Quit") type = CMD_QUIT;
+        
+        checksum += type;
+        for (int arg : args) checksum += arg;
+        lines++;
+    }
+    return lines;
+}
+
+// Mapped file decoded with CommandReader
+static long mappedParse(const char* path, long& checksum) {
+    MappedFile input;
+    if (!input.open(path)) {
+        std::perror(path);
+        std::exit(1);
+    }
+    
+    CommandReader reader(input.begin(), input.end());
+    Command command;
+    long lines = 0;
+    
+    while (reader.next(command)) {
+        checksum += command.type;
+        for (int i = 0; i < command.argCount; i++) checksum += command.args[i];
+        lines++;
+    }
+    return lines;
+}
+
+// Encode the text file as binary commands, like convertCommands
+static void convertInput(const char* path, const std::string& binaryPath) {
+    MappedFile input;
+    std::ofstream output(binaryPath.c_str(), std::ios::binary | std::ios::trunc);
+    if (!input.open(path) || !output.is_open()) {
+        std::perror(binaryPath.c_str());
+        std::exit(1);
+    }
+    
+    uint32_t header[4];
+    binaryCommandsHeader(header);
+    output.write(reinterpret_cast<const char*>(header), sizeof(header));
+    
+    CommandReader reader(input.begin(), input.end());
+    Command command;
+    CommandRecord record;
+    while (reader.next(command)) {
+        encodeCommand(command, record);
+        output.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    }
+}
+
+// Mapped binary file decoded with BinaryCommandReader
+static long binaryParse(const char* path, long& checksum) {
+    MappedFile input;
+    if (!input.open(path)) {
+        std::perror(path);
+        std::exit(1);
+    }
+    
+    BinaryCommandReader reader(input.begin(), input.end());
+    Command command;
+    long lines = 0;
+    
+    while (reader.next(command)) {
+        checksum += command.type;
+        for (int i = 0; i < command.argCount; i++) checksum += command.args[i];
+        lines++;
+    }
+    return lines;
+}
+
+int main(int argc, char* argv[]) {
+    long lines = argc > 1 ? std::atol(argv[1]) : 10000000;
+    const char* path = argc > 2 ? argv[2] : "parse_bench_input.txt";
+    
+    std::string binaryPath = std::string(path) + ".bin";
+    
+    generateInput(path, lines);
+    convertInput(path, binaryPath);
+    
+    std::printf("%-16s %12s %14s %16s\n", "parser", "lines", "Mlines/s", "checksum");
+    
+    const char* const names[] = {"getline+stoi", "mmap reader", "binary reader"};
+    for (int variant = 0; variant < 3; variant++) {
+        long checksum = 0;
+        auto begin = std::chrono::steady_clock::now();
+        long parsed = variant == 0 ? legacyParse(path, checksum)
+                    : variant == 1 ? mappedParse(path, checksum)
+                                   : binaryParse(binaryPath.c_str(), checksum);
+        auto end = std::chrono::steady_clock::now();
+        
+        double seconds = std::chrono::duration<double>(end - begin).count();
+        std::printf("%-16s %12ld %14.2f %16ld\n", names[variant], parsed, 
+                    parsed / seconds / 1e6, checksum);
+    }
+    
+    std::remove(path);
+    std::remove(binaryPath.c_str());
+    return 0;
+}
@@ -0,0 +1,138 @@
+// printActive cost: the original copy + sort + ostringstream path, a slot
+// sort with direct formatting, and the radix-sorted path now in Scheduler
+#include "FlightTable.h"
+#include "OutputSink.h"
+#include "RadixSort.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Formats everything, keeps a byte count
+class CountingSink : public OutputSink {
+public:
+    size_t bytes;
+    
+    CountingSink() : bytes(0) {}
+    
+protected:
+    void drain(const char*, size_t length) {
+        bytes += length;
+    }
+};
+
+// Write one active-flight line
+static void formatFlight(const FlightTable& flights, int slot, OutputSink& output) {
+    output << "[flight" << flights.flightIDs[slot] 
+           << ", airline" << flights.airlineIDs[slot] 
+           << ", runway" << flights.runwayIDs[slot] 
+           << ", start" << flights.startTimes[slot] 
+           << ", ETA" << flights.ETAs[slot] << "]";
+    output.endl();
+}
+
+// Copy every flight out, sort by ID, one ostringstream per line
+static size_t copySortPrint(const FlightTable& flights) {
+    std::vector<Flight> copies;
+    for (size_t i = 0; i < flights.size(); i++) {
+        copies.push_back(flights.get((int)i));
+    }
+    std::sort(copies.begin(), copies.end(), 
+              [](const Flight& a, const Flight& b) { return a.flightID < b.flightID; });
+    
+    std::vector<std::string> output;
+    size_t bytes = 0;
+    for (const Flight& f : copies) {
+        std::ostringstream oss;
+        oss << "[flight" << f.flightID << ", airline" << f.airlineID 
+            << ", runway" << f.runwayID << ", start" << f.startTime 
+            << ", ETA" << f.ETA << "]";
+        output.push_back(oss.str());
+        bytes += output.back().size() + 1;
+    }
+    return bytes;
+}
+
+// Comparison sort of slot indices, direct formatting
+static size_t slotSortPrint(const FlightTable& flights) {
+    std::vector<int> order(flights.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = (int)i;
+    }
+    const std::vector<int>& ids = flights.flightIDs;
+    std::sort(order.begin(), order.end(), 
+              [&ids](int a, int b) { return ids[a] < ids[b]; });
+    
+    CountingSink output;
+    for (int slot : order) {
+        formatFlight(flights, slot, output);
+    }
+    output.flush();
+    return output.bytes;
+}
+
+// Radix sort of (flightID, slot) with reused buffers, direct formatting
+static size_t radixSortPrint(const FlightTable& flights) {
+    static std::vector<uint64_t> order;
+    static std::vector<uint64_t> scratch;
+    order.resize(flights.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = radixItem(flights.flightIDs[i], (int)i);
+    }
+    radixSortByKey(order, scratch);
+    
+    CountingSink output;
+    for (uint64_t item : order) {
+        formatFlight(flights, radixPayload(item), output);
+    }
+    output.flush();
+    return output.bytes;
+}
+
+int main(int argc, char* argv[]) {
+    int rounds = argc > 1 ? std::atoi(argv[1]) : 20;
+    const int sizes[] = {1000, 10000, 100000};
+    
+    std::printf("%8s %18s %18s %18s\n", "flights", "copy+sort+oss ms", "slot sort ms", 
+                "radix sort ms");
+    
+    for (int n : sizes) {
+        // Shuffled IDs, as slots end up after swap-with-last erases
+        FlightTable flights;
+        std::vector<int> ids(n);
+        for (int i = 0; i < n; i++) ids[i] = i + 1;
+        unsigned seed = 12345;
+        for (int i = n - 1; i > 0; i--) {
+            seed = seed * 1103515245 + 12345;
+            std::swap(ids[i], ids[(seed >> 8) % (i + 1)]);
+        }
+        for (int i = 0; i < n; i++) {
+            Flight f(ids[i], ids[i] % 97, 0, ids[i] % 10, 1 + ids[i] % 30);
+            f.runwayID = 1 + ids[i] % 20;
+            f.startTime = ids[i] % 5000;
+            f.ETA = f.startTime + f.duration;
+            flights.insert(f);
+        }
+        
+        size_t (*const variants[])(const FlightTable&) = {copySortPrint, slotSortPrint, 
+                                                          radixSortPrint};
+        double ms[3];
+        size_t bytes[3];
+        for (int v = 0; v < 3; v++) {
+            auto begin = std::chrono::steady_clock::now();
+            for (int r = 0; r < rounds; r++) {
+                bytes[v] = variants[v](flights);
+            }
+            auto end = std::chrono::steady_clock::now();
+            ms[v] = std::chrono::duration<double, std::milli>(end - begin).count() / rounds;
+        }
+        
+        std::printf("%8d %18.3f %18.3f %18.3f%s\n", n, ms[0], ms[1], ms[2], 
+                    bytes[0] == bytes[1] && bytes[1] == bytes[2] ? "" : "  (output mismatch)");
+    }
+    
+    return 0;
+}
@@ -0,0 +1,234 @@
+// Queue backend matrix: each Scheduler queue role driven the way the
+// scheduler drives it, for every backend that can fill the role, at a range
+// of queue sizes. Throughput in million operations per second; the fastest
+// backend per size is marked with *. Checksums must agree within a role.
+#include "QueuePolicy.h"
+#include "Runway.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+static double seconds(Clock::time_point begin) {
+    return std::chrono::duration<double>(Clock::now() - begin).count();
+}
+
+// Deterministic generator shared by every backend
+struct Lcg {
+    unsigned state;
+    
+    Lcg(unsigned seed) : state(seed) {}
+    
+    int next(int range) {
+        state = state * 1103515245 + 12345;
+        return (int)((state >> 8) % (unsigned)range);
+    }
+};
+
+// Ops per second and result checksum of one run
+struct Result {
+    double mops;
+    long checksum;
+};
+
+// Pending queue: queue every flight, re-key a quarter (Reprioritize) and
+// drop an eighth (cancellations), then drain in greedy order as a replan does
+template<typename Queue>
+Result runPending(int n, int rounds) {
+    Queue queue;
+    std::vector<typename Queue::Handle> handles(n);
+    std::vector<bool> erased(n);
+    long checksum = 0;
+    long ops = 0;
+    
+    auto begin = Clock::now();
+    for (int r = 0; r < rounds; r++) {
+        Lcg rng(2024 + r);
+        queue.clear();
+        for (int i = 0; i < n; i++) {
+            PlanKey key;
+            key.priority = rng.next(10);
+            key.submitTime = rng.next(1000);
+            key.flightID = i + 1;
+            handles[i] = queue.push(key, i);
+            erased[i] = false;
+        }
+        for (int k = 0; k < n / 4; k++) {
+            int i = rng.next(n);
+            if (!erased[i]) queue.increaseKey(handles[i], handles[i]->priority + 1 + rng.next(3));
+        }
+        for (int k = 0; k < n / 8; k++) {
+            int i = rng.next(n);
+            if (!erased[i]) {
+                queue.erase(handles[i]);
+                erased[i] = true;
+            }
+        }
+        long position = 0;
+        while (!queue.empty()) {
+            checksum += queue.top() * ++position % 1000003;
+            queue.pop();
+        }
+        ops += n + n / 4 + n / 8 + n;
+    }
+    Result result = {ops / seconds(begin) / 1e6, checksum};
+    return result;
+}
+
+// Runway pool: n runways; each assignment takes the earliest free runway
+// and re-keys it to when the flight lands, as the greedy pass does
+template<typename Queue>
+Result runRunways(int n, int rounds) {
+    Queue queue;
+    long checksum = 0;
+    long ops = 0;
+    int assignments = 500000;
+    
+    auto begin = Clock::now();
+    for (int r = 0; r < rounds; r++) {
+        Lcg rng(7 + r);
+        queue.clear();
+        for (int i = 0; i < n; i++) {
+            queue.push(i, Runway(i, rng.next(100)));
+        }
+        for (int k = 0; k < assignments; k++) {
+            Runway runway = queue.top();
+            checksum += runway.runwayID;
+            runway.nextFreeTime += 1 + rng.next(30);
+            queue.update(runway.runwayID, runway);
+        }
+        ops += n + assignments;
+    }
+    Result result = {ops / seconds(begin) / 1e6, checksum};
+    return result;
+}
+
+// Timetable: a steady state of n flights whose ETAs lie ahead of the
+// clock. Each step replans some flights to later ETAs, cancels one and
+// queues a new one, then advances the clock and pops everything that landed.
+template<typename Queue>
+Result runTimetable(int n, int rounds) {
+    Queue queue;
+    long checksum = 0;
+    long ops = 0;
+    int span = 4 * n;
+    int steps = 200000;
+    
+    auto begin = Clock::now();
+    for (int r = 0; r < rounds; r++) {
+        Lcg rng(99 + r);
+        queue.clear();
+        int now = 0;
+        int nextID = 0;
+        for (; nextID < n; nextID++) {
+            queue.push(nextID, TimetableEntry(rng.next(span), nextID, 0));
+        }
+        ops += n;
+        for (int s = 0; s < steps; s++) {
+            for (int k = 0; k < 4; k++) {
+                int id = nextID - 1 - rng.next(n);
+                if (queue.contains(id)) {
+                    queue.update(id, TimetableEntry(now + rng.next(span), id, 0));
+                }
+            }
+            queue.erase(nextID - 1 - rng.next(n));
+            queue.push(nextID, TimetableEntry(now + rng.next(span), nextID, 0));
+            nextID++;
+            ops += 6;
+            
+            now += 4;
+            while (!queue.empty() && queue.top().ETA <= now) {
+                checksum += queue.topID();
+                queue.pop();
+                ops++;
+            }
+        }
+    }
+    Result result = {ops / seconds(begin) / 1e6, checksum};
+    return result;
+}
+
+// One table row per backend, one column per size
+struct Row {
+    std::string name;
+    std::vector<Result> results;
+};
+
+static void printRole(const char* role, const std::vector<int>& sizes,
+                      const std::vector<Row>& rows) {
+    std::printf("\n%-22s", role);
+    for (int n : sizes) std::printf(" %11d", n);
+    std::printf("\n");
+    for (const Row& row : rows) {
+        std::printf("%-22s", row.name.c_str());
+        for (size_t c = 0; c < sizes.size(); c++) {
+            bool best = true;
+            for (const Row& other : rows) {
+                if (other.results[c].mops > row.results[c].mops) best = false;
+            }
+            std::printf(" %10.2f%c", row.results[c].mops, best ? '*' : ' ');
+        }
+        std::printf("\n");
+    }
+    for (size_t c = 0; c < sizes.size(); c++) {
+        for (const Row& row : rows) {
+            if (row.results[c].checksum != rows[0].results[c].checksum) {
+                std::printf("checksum mismatch: %s at %d\n", row.name.c_str(), sizes[c]);
+            }
+        }
+    }
+}
+
+template<typename Queue>
+static Row pendingRow(const char* name, const std::vector<int>& sizes, int rounds) {
+    Row row = {name, std::vector<Result>()};
+    for (int n : sizes) row.results.push_back(runPending<Queue>(n, rounds));
+    return row;
+}
+
+template<typename Queue>
+static Row runwayRow(const char* name, const std::vector<int>& sizes, int rounds) {
+    Row row = {name, std::vector<Result>()};
+    for (int n : sizes) row.results.push_back(runRunways<Queue>(n, rounds));
+    return row;
+}
+
+template<typename Queue>
+static Row timetableRow(const char* name, const std::vector<int>& sizes, int rounds) {
+    Row row = {name, std::vector<Result>()};
+    for (int n : sizes) row.results.push_back(runTimetable<Queue>(n, rounds));
+    return row;
+}
+
+int main(int argc, char* argv[]) {
+    int rounds = argc > 1 ? std::max(1, std::atoi(argv[1])) : 1;
+    std::vector<int> sizes;
+    sizes.push_back(16);
+    sizes.push_back(1000);
+    sizes.push_back(100000);
+    sizes.push_back(1000000);
+    
+    std::printf("Mops/s by queue size, %d rounds\n", rounds);
+    
+    std::vector<Row> rows;
+    rows.push_back(pendingRow<PairingHeap>("pairing", sizes, rounds));
+    rows.push_back(pendingRow<RankPairingHeap>("rank-pairing", sizes, rounds));
+    printRole("pending flights", sizes, rows);
+    
+    rows.clear();
+    rows.push_back(runwayRow<IndexedMinHeap<Runway, 2>>("binary heap", sizes, rounds));
+    rows.push_back(runwayRow<IndexedMinHeap<Runway, 4>>("4-ary heap", sizes, rounds));
+    rows.push_back(runwayRow<IndexedMinHeap<Runway, 8>>("8-ary heap", sizes, rounds));
+    printRole("runway pool", sizes, rows);
+    
+    rows.clear();
+    rows.push_back(timetableRow<IndexedMinHeap<TimetableEntry, 2>>("binary heap", sizes, rounds));
+    rows.push_back(timetableRow<IndexedMinHeap<TimetableEntry, 4>>("4-ary heap", sizes, rounds));
+    rows.push_back(timetableRow<IndexedRadixHeap<TimetableEntry>>("radix heap", sizes, rounds));
+    printRole("timetable/start queue", sizes, rows);
+    return 0;
+}
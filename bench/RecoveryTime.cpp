@@ -0,0 +1,143 @@
+// Recovery time vs. journal length: re-parsing and replaying the text
+// command log, replaying the binary journal, and recovering from periodic
+// checkpoints plus the journal tail. logged_run is the original run with
+// journaling on.
+#include "Journal.h"
+#include "Workload.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+typedef std::chrono::steady_clock Clock;
+
+static double msSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Parse and run a text log
+static double replayText(const std::string& text) {
+    auto start = Clock::now();
+    RunwayGroups scheduler(1);
+    DiscardSink output;
+    CommandReader reader(text.data(), text.data() + text.size());
+    Command command;
+    while (reader.next(command)) {
+        scheduler.execute(command, output);
+    }
+    return msSince(start);
+}
+
+// Parse a text log without running it
+static double parseText(const std::string& text, size_t& commands) {
+    auto start = Clock::now();
+    CommandReader reader(text.data(), text.data() + text.size());
+    Command command;
+    commands = 0;
+    while (reader.next(command)) {
+        commands++;
+    }
+    return msSince(start);
+}
+
+// Journal every state-changing command of a text log, running it too so
+// checkpoints see real state; returns the time spent
+static double writeJournal(const std::string& text, const std::string& path,
+                           size_t checkpointEvery) {
+    RunwayGroups scheduler(1);
+    DiscardSink output;
+    Journal journal;
+    if (!journal.create(path, 64)) {
+        std::perror(path.c_str());
+        return -1;
+    }
+    
+    auto start = Clock::now();
+    CommandReader reader(text.data(), text.data() + text.size());
+    Command command;
+    while (reader.next(command)) {
+        if (Journal::journaled(command)) {
+            journal.append(command);
+        }
+        scheduler.execute(command, output);
+        if (checkpointEvery > 0 && journal.sinceCheckpoint() >= checkpointEvery) {
+            journal.checkpoint(scheduler);
+        }
+    }
+    journal.commit();
+    return msSince(start);
+}
+
+// Decode a journal without running it
+static double readJournal(const std::string& path) {
+    auto start = Clock::now();
+    JournalReader reader;
+    if (!reader.open(path)) return -1;
+    Command command;
+    size_t records = 0;
+    while (reader.next(command)) {
+        records++;
+    }
+    return records > 0 ? msSince(start) : -1;
+}
+
+// Full recovery: checkpoint load plus journal replay
+static double recoverJournal(const std::string& path) {
+    auto start = Clock::now();
+    RunwayGroups scheduler(1);
+    Journal journal;
+    if (!journal.recover(path, 64, scheduler)) return -1;
+    return msSince(start);
+}
+
+int main(int argc, char* argv[]) {
+    WorkloadConfig config;
+    std::string dir = "/tmp";
+    size_t checkpointEvery = 20000;
+    
+    for (int i = 1; i < argc; i++) {
+        if (std::strncmp(argv[i], "--dir=", 6) == 0) {
+            dir = argv[i] + 6;
+        } else if (std::strncmp(argv[i], "--checkpoint-every=", 19) == 0) {
+            checkpointEvery = (size_t)std::atoi(argv[i] + 19);
+        } else if (!config.parseOption(argv[i])) {
+            std::fprintf(stderr, "Usage: %s [--dir=PATH] [--checkpoint-every=N] [options]\n%s",
+                         argv[0], WORKLOAD_OPTIONS);
+            return 1;
+        }
+    }
+    
+    std::string plainPath = dir + "/recoveryTime.wal";
+    std::string checkpointedPath = dir + "/recoveryTimeCheckpointed.wal";
+    int baseFlights = config.flights;
+    const int scales[] = {1, 2, 5, 10, 20};
+    
+    std::printf("checkpoint every %zu journaled commands; times in ms\n", checkpointEvery);
+    std::printf("%9s %8s %9s %9s %9s %9s %10s %12s\n", "commands", "log_KiB", "parse",
+                "text", "jrnl_read", "journal", "logged_run", "checkpointed");
+    
+    for (int scale : scales) {
+        config.flights = baseFlights * scale / 20;
+        std::string text;
+        WorkloadGenerator(config).generate(text);
+        
+        size_t commands;
+        double parse = parseText(text, commands);
+        double textReplay = replayText(text);
+        double write = writeJournal(text, plainPath, 0);
+        double read = readJournal(plainPath);
+        double journalReplay = recoverJournal(plainPath);
+        writeJournal(text, checkpointedPath, checkpointEvery);
+        double checkpointed = recoverJournal(checkpointedPath);
+        
+        std::printf("%9zu %8zu %9.1f %9.1f %9.1f %9.1f %10.1f %12.1f\n", commands,
+                    text.size() / 1024, parse, textReplay, read, journalReplay, write,
+                    checkpointed);
+    }
+    
+    std::remove(plainPath.c_str());
+    std::remove((plainPath + ".checkpoint").c_str());
+    std::remove(checkpointedPath.c_str());
+    std::remove((checkpointedPath + ".checkpoint").c_str());
+    return 0;
+}
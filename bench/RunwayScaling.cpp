@@ -0,0 +1,50 @@
+// Runway pool scaling: per-command cost as the runway count grows
+#include "Scheduler.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+int main(int argc, char* argv[]) {
+    int flightsPerRunway = argc > 1 ? std::atoi(argv[1]) : 100;
+    int commands = argc > 2 ? std::atoi(argv[2]) : 2000;
+    const int runwayCounts[] = {10, 50, 100, 250, 500};
+    
+    std::printf("%8s %10s %10s %12s\n", "runways", "flights", "commands", "us/command");
+    
+    for (int runways : runwayCounts) {
+        Scheduler scheduler;
+        StringSink output;
+        scheduler.initialize(runways, output);
+        
+        // Equal-priority backlog, appended to the end of the greedy order
+        unsigned seed = 12345;
+        int flightID = 1;
+        int flights = runways * flightsPerRunway;
+        for (int i = 0; i < flights; i++) {
+            seed = seed * 1103515245 + 12345;
+            scheduler.submitFlight(flightID++, (seed >> 8) % 100, 0, 5, 
+                                   5 + (seed >> 16) % 30, output);
+            output.clear();
+        }
+        
+        // Alternate low-priority submits with ticks that start flights
+        auto begin = std::chrono::steady_clock::now();
+        for (int i = 0; i < commands; i++) {
+            int time = 1 + i / 4;
+            seed = seed * 1103515245 + 12345;
+            if (i % 2 == 0) {
+                scheduler.submitFlight(flightID++, (seed >> 8) % 100, time, 0, 
+                                       5 + (seed >> 16) % 30, output);
+            } else {
+                scheduler.tick(time, output);
+            }
+            output.clear();
+        }
+        auto end = std::chrono::steady_clock::now();
+        
+        double us = std::chrono::duration<double, std::micro>(end - begin).count();
+        std::printf("%8d %10d %10d %12.2f\n", runways, flights, commands, us / commands);
+    }
+    
+    return 0;
+}
@@ -0,0 +1,103 @@
+// Per-command latency percentiles and throughput of the scheduler on a
+// generated workload or an existing input file
+#include "CommandReader.h"
+#include "Scheduler.h"
+#include "Workload.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Value at quantile q of sorted samples
+static double percentile(const std::vector<double>& sorted, double q) {
+    size_t i = (size_t)(q * (sorted.size() - 1) + 0.5);
+    return sorted[i];
+}
+
+// Print one row of latency statistics in microseconds
+static void report(const char* name, std::vector<double>& samples) {
+    if (samples.empty()) return;
+    std::sort(samples.begin(), samples.end());
+    
+    double sum = 0;
+    for (double s : samples) sum += s;
+    
+    std::printf("%-14s %9zu %9.2f %9.2f %9.2f %9.2f %9.2f %10.2f\n", name, samples.size(),
+                sum / samples.size(), percentile(samples, 0.5), percentile(samples, 0.9),
+                percentile(samples, 0.99), percentile(samples, 0.999), samples.back());
+}
+
+int main(int argc, char* argv[]) {
+    WorkloadConfig config;
+    const char* inputPath = nullptr;
+    
+    for (int i = 1; i < argc; i++) {
+        if (std::strncmp(argv[i], "--input=", 8) == 0) {
+            inputPath = argv[i] + 8;
+        } else if (!config.parseOption(argv[i])) {
+            std::fprintf(stderr, "Usage: %s [--input=FILE] [options]\n%s", argv[0],
+                         WORKLOAD_OPTIONS);
+            return 1;
+        }
+    }
+    
+    // Decode everything up front so only scheduler work is timed
+    std::string text;
+    MappedFile file;
+    const char* begin;
+    const char* end;
+    if (inputPath) {
+        if (!file.open(inputPath)) {
+            std::perror(inputPath);
+            return 1;
+        }
+        begin = file.begin();
+        end = file.end();
+    } else {
+        WorkloadGenerator(config).generate(text);
+        begin = text.data();
+        end = text.data() + text.size();
+    }
+    
+    std::vector<Command> commands;
+    CommandReader reader(begin, end);
+    Command command;
+    while (reader.next(command)) {
+        commands.push_back(command);
+        if (command.stop) break;
+    }
+    
+    Scheduler scheduler;
+    DiscardSink output;
+    std::vector<std::vector<double>> samples(COMMAND_TYPES);
+    std::vector<double> all;
+    all.reserve(commands.size());
+    
+    auto runBegin = std::chrono::steady_clock::now();
+    for (const Command& c : commands) {
+        auto t0 = std::chrono::steady_clock::now();
+        scheduler.execute(c, output);
+        auto t1 = std::chrono::steady_clock::now();
+        
+        double us = std::chrono::duration<double, std::micro>(t1 - t0).count();
+        samples[c.type].push_back(us);
+        all.push_back(us);
+    }
+    output.flush();
+    auto runEnd = std::chrono::steady_clock::now();
+    
+    std::printf("%-14s %9s %9s %9s %9s %9s %9s %10s\n", "command (us)", "count", "mean",
+                "p50", "p90", "p99", "p99.9", "max");
+    for (int type = CMD_INITIALIZE; type < COMMAND_TYPES; type++) {
+        report(commandName((CommandType)type), samples[type]);
+    }
+    report("all", all);
+    
+    double seconds = std::chrono::duration<double>(runEnd - runBegin).count();
+    std::printf("\n%zu commands in %.3f s: %.0f commands/s\n", commands.size(), seconds,
+                commands.size() / seconds);
+    
+    return 0;
+}
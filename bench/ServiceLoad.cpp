@@ -0,0 +1,227 @@
+// Request latency of the socket service (--serve) under open-loop load.
+// Each client connection sends requests on a fixed schedule; latency is
+// measured from the scheduled send time, so a slow server is charged for
+// the requests queued behind it. Without --socket a server is started
+// in-process on a temporary socket, with --readers=N query threads.
+#include "SchedulerServer.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+// Value at quantile q of sorted samples
+static double percentile(const std::vector<double>& sorted, double q) {
+    size_t i = (size_t)(q * (sorted.size() - 1) + 0.5);
+    return sorted[i];
+}
+
+static int connectTo(const std::string& path) {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0 && ::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    return fd;
+}
+
+// Blocking request/reply over one connection
+class Connection {
+private:
+    int fd;
+    char buffer[1 << 16];
+    size_t filled;
+    size_t pos;
+    bool atLineStart;
+
+public:
+    explicit Connection(int socket) : fd(socket), filled(0), pos(0), atLineStart(true) {}
+    ~Connection() { if (fd >= 0) ::close(fd); }
+    
+    bool send(const std::string& request) {
+        size_t sent = 0;
+        while (sent < request.size()) {
+            ssize_t n = ::send(fd, request.data() + sent, request.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0) return false;
+            sent += n;
+        }
+        return true;
+    }
+    
+    // Consume one reply: its output lines and the empty line ending it
+    bool awaitReply() {
+        while (true) {
+            while (pos < filled) {
+                char c = buffer[pos++];
+                if (c == '\n' && atLineStart) return true;
+                atLineStart = c == '\n';
+            }
+            ssize_t n = ::recv(fd, buffer, sizeof(buffer), 0);
+            if (n <= 0) return false;
+            filled = n;
+            pos = 0;
+        }
+    }
+};
+
+// Requests of one client: mostly submissions, with schedule queries and
+// ticks; times follow the wall clock in 10 ms units
+static std::string makeRequest(int sequence, int time, unsigned& seed) {
+    char line[128];
+    seed = seed * 1103515245u + 12345u;
+    int kind = (seed >> 16) % 100;
+    if (kind < 60) {
+        int flightID = sequence + 1;
+        int eta = time + 1 + (int)((seed >> 8) % 50);
+        std::snprintf(line, sizeof(line), "SubmitFlight(%d, %d, %d, %d, %d, %d)\n", time,
+                      flightID, (int)(seed % 20) + 1, eta, 2 + (int)((seed >> 4) % 5),
+                      (int)((seed >> 12) % 10));
+    } else if (kind < 85) {
+        std::snprintf(line, sizeof(line), "PrintSchedule(%d, %d)\n", time, time + 20);
+    } else {
+        std::snprintf(line, sizeof(line), "Tick(%d)\n", time);
+    }
+    return line;
+}
+
+// Run every client at rate / clients requests per second for seconds;
+// returns latencies in microseconds, or false on a connection failure
+static bool runLoad(const std::string& path, int clients, double rate, double seconds,
+                    Clock::time_point epoch, std::vector<double>& latencies) {
+    std::vector<std::vector<double> > samples(clients);
+    std::atomic<bool> failed(false);
+    std::vector<std::thread> threads;
+    Clock::time_point start = Clock::now();
+    
+    for (int c = 0; c < clients; c++) {
+        threads.emplace_back([&, c]() {
+            Connection connection(connectTo(path));
+            std::chrono::duration<double> interval(clients / rate);
+            int requests = (int)(seconds * rate / clients);
+            unsigned seed = 7919u * (c + 1);
+            // Flight IDs are unique across clients and runs
+            static std::atomic<int> sequence(0);
+            // Stagger clients across one interval
+            Clock::time_point due = start + std::chrono::duration_cast<Clock::duration>(
+                                                interval * ((double)c / clients));
+            samples[c].reserve(requests);
+            
+            for (int i = 0; i < requests && !failed; i++) {
+                std::this_thread::sleep_until(due);
+                int time = (int)(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                     Clock::now() - epoch).count() / 10);
+                std::string request = makeRequest(sequence++, time, seed);
+                if (!connection.send(request) || !connection.awaitReply()) {
+                    failed = true;
+                    break;
+                }
+                samples[c].push_back(
+                    std::chrono::duration<double, std::micro>(Clock::now() - due).count());
+                due += std::chrono::duration_cast<Clock::duration>(interval);
+            }
+        });
+    }
+    for (std::thread& t : threads) t.join();
+    
+    latencies.clear();
+    for (const std::vector<double>& s : samples) {
+        latencies.insert(latencies.end(), s.begin(), s.end());
+    }
+    return !failed;
+}
+
+int main(int argc, char* argv[]) {
+    std::string path;
+    int clients = 8;
+    int readers = 0;
+    double seconds = 1.0;
+    std::vector<double> rates;
+    
+    for (int i = 1; i < argc; i++) {
+        if (std::strncmp(argv[i], "--socket=", 9) == 0) {
+            path = argv[i] + 9;
+        } else if (std::strncmp(argv[i], "--clients=", 10) == 0) {
+            clients = std::max(1, std::atoi(argv[i] + 10));
+        } else if (std::strncmp(argv[i], "--readers=", 10) == 0) {
+            readers = std::max(0, std::atoi(argv[i] + 10));
+        } else if (std::strncmp(argv[i], "--seconds=", 10) == 0) {
+            seconds = std::atof(argv[i] + 10);
+        } else if (std::strncmp(argv[i], "--rate=", 7) == 0) {
+            rates.push_back(std::atof(argv[i] + 7));
+        } else {
+            std::fprintf(stderr, "Usage: %s [--socket=PATH] [--clients=N] [--readers=N] [--seconds=S] "
+                         "[--rate=REQUESTS_PER_SEC]...\n", argv[0]);
+            return 1;
+        }
+    }
+    if (rates.empty()) {
+        rates = {2000, 10000, 20000, 50000};
+    }
+    
+    // In-process server unless one is given
+    RunwayGroups scheduler(1);
+    SchedulerServer server(scheduler, LoopOptions(), readers);
+    std::thread serverThread;
+    if (path.empty()) {
+        path = "/tmp/serviceLoad." + std::to_string(::getpid()) + ".sock";
+        if (!server.listen(path)) {
+            std::perror(path.c_str());
+            return 1;
+        }
+        serverThread = std::thread([&]() { server.run(); });
+    }
+    
+    Clock::time_point epoch = Clock::now();
+    {
+        Connection setup(connectTo(path));
+        if (!setup.send("Initialize(8)\n") || !setup.awaitReply()) {
+            std::fprintf(stderr, "Cannot reach server at %s\n", path.c_str());
+            if (serverThread.joinable()) {
+                server.requestStop();
+                serverThread.join();
+            }
+            return 1;
+        }
+    }
+    
+    std::printf("%d clients, %d readers, %.1f s per rate; latency in us from scheduled send\n",
+                clients, readers, seconds);
+    std::printf("%10s %10s %9s %9s %9s %9s %10s\n", "offered/s", "achieved/s", "p50", "p90",
+                "p99", "p99.9", "max");
+    
+    std::vector<double> latencies;
+    for (double rate : rates) {
+        Clock::time_point start = Clock::now();
+        bool ok = runLoad(path, clients, rate, seconds, epoch, latencies);
+        double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        if (!ok || latencies.empty()) {
+            std::printf("%10.0f connection failed\n", rate);
+            break;
+        }
+        std::sort(latencies.begin(), latencies.end());
+        std::printf("%10.0f %10.0f %9.1f %9.1f %9.1f %9.1f %10.1f\n", rate,
+                    latencies.size() / elapsed, percentile(latencies, 0.5),
+                    percentile(latencies, 0.9), percentile(latencies, 0.99),
+                    percentile(latencies, 0.999), latencies.back());
+    }
+    
+    if (serverThread.joinable()) {
+        server.requestStop();
+        serverThread.join();
+    }
+    return 0;
+}
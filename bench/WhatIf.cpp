@@ -0,0 +1,120 @@
+// What-if cost: evaluating AddRunways + GroundHold + PrintSchedule on a
+// Simulate()/Discard() branch of the live state, against a snapshot round
+// trip (deep copy, indexes rebuilt, full replan) and replaying the whole
+// command log into a fresh scheduler. fork is Simulate() + Discard() alone.
+#include "RunwayGroups.h"
+#include "Workload.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+typedef std::chrono::steady_clock Clock;
+
+static double msSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Parse and run a command log; returns the time of the last Tick
+static int replay(const std::string& text, RunwayGroups& scheduler) {
+    DiscardSink output;
+    CommandReader reader(text.data(), text.data() + text.size());
+    Command command;
+    int time = 0;
+    while (reader.next(command)) {
+        scheduler.execute(command, output);
+        if (command.type == CMD_TICK && command.argCount >= 1) {
+            time = command.args[0];
+        }
+    }
+    return time;
+}
+
+// The hypothetical commands, at time
+static void runWhatIf(RunwayGroups& scheduler, int time) {
+    char text[160];
+    std::snprintf(text, sizeof(text), "AddRunways(2, %d)\nGroundHold(1, 3, %d)\n"
+                  "PrintSchedule(%d, %d)\n", time, time, time, time + 50);
+    DiscardSink output;
+    CommandReader reader(text, text + std::strlen(text));
+    Command command;
+    while (reader.next(command)) {
+        scheduler.execute(command, output);
+    }
+}
+
+// Run one command given as text
+static void runLine(RunwayGroups& scheduler, const char* line) {
+    DiscardSink output;
+    Command command;
+    parseCommandLine(line, line + std::strlen(line), command);
+    scheduler.execute(command, output);
+}
+
+int main(int argc, char* argv[]) {
+    WorkloadConfig config;
+    std::string dir = "/tmp";
+    
+    for (int i = 1; i < argc; i++) {
+        if (std::strncmp(argv[i], "--dir=", 6) == 0) {
+            dir = argv[i] + 6;
+        } else if (!config.parseOption(argv[i])) {
+            std::fprintf(stderr, "Usage: %s [--dir=PATH] [options]\n%s", argv[0],
+                         WORKLOAD_OPTIONS);
+            return 1;
+        }
+    }
+    
+    std::string path = dir + "/whatIf.snapshot";
+    int baseFlights = config.flights;
+    const int scales[] = {1, 2, 5, 10, 20};
+    
+    std::printf("times in ms\n");
+    std::printf("%9s %8s %9s %9s %9s %9s\n", "commands", "active", "fork", "what_if",
+                "snapshot", "replay");
+    
+    for (int scale : scales) {
+        config.flights = baseFlights * scale / 20;
+        std::string text;
+        WorkloadGenerator(config).generate(text);
+        
+        RunwayGroups live(1);
+        int time = replay(text, live);
+        live.publishView();
+        size_t active = 0;
+        for (const ActiveSet& group : live.view()->active) active += group.size();
+        size_t commands = 0;
+        for (char c : text) commands += c == '\n';
+        
+        auto start = Clock::now();
+        runLine(live, "Simulate()");
+        runLine(live, "Discard()");
+        double fork = msSince(start);
+        
+        start = Clock::now();
+        runLine(live, "Simulate()");
+        runWhatIf(live, time);
+        runLine(live, "Discard()");
+        double whatIf = msSince(start);
+        
+        start = Clock::now();
+        uint32_t generation;
+        live.saveSnapshot(path, 0);
+        RunwayGroups copy(1);
+        copy.loadSnapshot(path, generation);
+        runWhatIf(copy, time);
+        double snapshot = msSince(start);
+        
+        start = Clock::now();
+        RunwayGroups replayed(1);
+        replay(text, replayed);
+        runWhatIf(replayed, time);
+        double replayTime = msSince(start);
+        
+        std::printf("%9zu %8zu %9.2f %9.2f %9.2f %9.2f\n", commands, active, fork, whatIf,
+                    snapshot, replayTime);
+    }
+    
+    std::remove(path.c_str());
+    return 0;
+}
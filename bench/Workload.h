@@ -0,0 +1,152 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+// Shape of a synthetic command stream
+struct WorkloadConfig {
+    int flights;           // SubmitFlight commands to issue
+    int runways;           // Initialize(runways)
+    int airlines;          // Airline IDs are drawn from [1, airlines]
+    int priorities;        // Priorities are drawn from [0, priorities)
+    bool skewed;           // Low priorities far more common than high ones
+    int maxDuration;       // Durations are drawn from [1, maxDuration]
+    // Other commands, weighted against 100 submits
+    int cancelPercent;
+    int reprioritizePercent;
+    int groundHoldPercent;
+    int printPercent;      // Split between PrintSchedule and PrintActive
+    int tickEvery;         // Average commands between ticks
+    int tickStep;          // Each tick advances time by [1, tickStep]
+    unsigned seed;
+    
+    WorkloadConfig()
+        : flights(100000), runways(40), airlines(50), priorities(10), skewed(false),
+          maxDuration(30), cancelPercent(10), reprioritizePercent(10),
+          groundHoldPercent(1), printPercent(1), tickEvery(5), tickStep(2), seed(1) {}
+    
+    // Apply a "--name=value" option; returns false if it is not recognized
+    bool parseOption(const char* option) {
+        const char* eq = std::strchr(option, '=');
+        if (std::strncmp(option, "--", 2) != 0 || !eq) return false;
+        
+        std::string name(option + 2, eq);
+        const char* value = eq + 1;
+        if (name == "priority-dist") {
+            if (std::strcmp(value, "skewed") == 0) skewed = true;
+            else if (std::strcmp(value, "uniform") == 0) skewed = false;
+            else return false;
+            return true;
+        }
+        
+        int number = std::atoi(value);
+        if (name == "flights") flights = number;
+        else if (name == "runways") runways = number;
+        else if (name == "airlines") airlines = number;
+        else if (name == "priorities") priorities = number;
+        else if (name == "max-duration") maxDuration = number;
+        else if (name == "cancel") cancelPercent = number;
+        else if (name == "reprioritize") reprioritizePercent = number;
+        else if (name == "ground-hold") groundHoldPercent = number;
+        else if (name == "print") printPercent = number;
+        else if (name == "tick-every") tickEvery = number;
+        else if (name == "tick-step") tickStep = number;
+        else if (name == "seed") seed = (unsigned)number;
+        else return false;
+        return true;
+    }
+};
+
+// Option summary for usage messages
+static const char* const WORKLOAD_OPTIONS =
+    "  --flights=N --runways=N --airlines=N --priorities=N\n"
+    "  --priority-dist=uniform|skewed --max-duration=N\n"
+    "  --cancel=PCT --reprioritize=PCT --ground-hold=PCT --print=PCT\n"
+    "  --tick-every=N --tick-step=N --seed=N\n";
+
+// Generates an input file for the scheduler, one command per line
+class WorkloadGenerator {
+private:
+    WorkloadConfig config;
+    unsigned state;
+    
+    // Uniform draw from [0, bound)
+    int draw(int bound) {
+        state = state * 1103515245 + 12345;
+        return bound > 0 ? (int)((state >> 8) % (unsigned)bound) : 0;
+    }
+    
+    // Priority per the configured distribution
+    int drawPriority() {
+        if (!config.skewed) return draw(config.priorities);
+        
+        // Each level is about half as likely as the one below it
+        int priority = 0;
+        while (priority + 1 < config.priorities && draw(2) == 0) {
+            priority++;
+        }
+        return priority;
+    }
+    
+    void emit(std::string& out, const char* line) {
+        out += line;
+        out += '\n';
+    }
+
+public:
+    explicit WorkloadGenerator(const WorkloadConfig& c) : config(c), state(c.seed) {}
+    
+    // Append the whole command stream to out
+    void generate(std::string& out) {
+        char line[96];
+        int time = 0;
+        int submitted = 0;
+        
+        std::snprintf(line, sizeof(line), "Initialize(%d)", config.runways);
+        emit(out, line);
+        
+        // Non-submit commands are weighted against 100 for SubmitFlight
+        int total = 100 + config.cancelPercent + config.reprioritizePercent +
+                    config.groundHoldPercent + config.printPercent;
+        
+        while (submitted < config.flights) {
+            if (config.tickEvery > 0 && draw(config.tickEvery) == 0) {
+                time += 1 + draw(config.tickStep);
+                std::snprintf(line, sizeof(line), "Tick(%d)", time);
+                emit(out, line);
+                continue;
+            }
+            
+            int r = draw(total);
+            if ((r -= 100) < 0) {
+                submitted++;
+                std::snprintf(line, sizeof(line), "SubmitFlight(%d, %d, %d, %d, %d)",
+                              submitted, 1 + draw(config.airlines), time, drawPriority(),
+                              1 + draw(config.maxDuration));
+            } else if ((r -= config.cancelPercent) < 0) {
+                std::snprintf(line, sizeof(line), "CancelFlight(%d, %d)",
+                              1 + draw(submitted + 1), time);
+            } else if ((r -= config.reprioritizePercent) < 0) {
+                std::snprintf(line, sizeof(line), "Reprioritize(%d, %d, %d)",
+                              1 + draw(submitted + 1), time, drawPriority());
+            } else if ((r -= config.groundHoldPercent) < 0) {
+                int low = 1 + draw(config.airlines);
+                std::snprintf(line, sizeof(line), "GroundHold(%d, %d, %d)",
+                              low, low + draw(3), time);
+            } else if (draw(2) == 0) {
+                std::snprintf(line, sizeof(line), "PrintSchedule(%d, %d)",
+                              time, time + 2 * config.maxDuration);
+            } else {
+                std::snprintf(line, sizeof(line), "PrintActive()");
+            }
+            emit(out, line);
+        }
+        
+        emit(out, "Quit()");
+    }
+};
+
+#endif // WORKLOAD_H
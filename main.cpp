@@ -1,79 +1,108 @@
-#include "Scheduler.h"
+#include "CommandLoop.h"
+#include "SchedulerServer.h"
+#include <csignal>
+#include <cstdlib>
 #include <iostream>
-#include <fstream>
-#include <sstream>
 #include <string>
-#include <vector>
 
-// Parse command line and execute scheduler operation
-void parseAndExecute(const std::string& line, Scheduler& scheduler, 
-                     std::vector<std::string>& output) {
-    size_t openParen = line.find('(');
-    if (openParen == std::string::npos) return;
-    
-    std::string command = line.substr(0, openParen);
-    size_t closeParen = line.find(')');
-    std::string argsStr = line.substr(openParen + 1, closeParen - openParen - 1);
-    
-    std::vector<int> args;
-    std::stringstream ss(argsStr);
-    std::string token;
-    
-    while (std::getline(ss, token, ',')) {
-        token.erase(0, token.find_first_not_of(" \t"));
-        token.erase(token.find_last_not_of(" \t") + 1);
-        if (!token.empty()) {
-            args.push_back(std::stoi(token));
-        }
-    }
-    
-    if (command == "Initialize") {
-        if (args.size() >= 1) {
-            scheduler.initialize(args[0], output);
-        }
-    } else if (command == "SubmitFlight") {
-        if (args.size() >= 5) {
-            scheduler.submitFlight(args[0], args[1], args[2], args[3], args[4], output);
-        }
-    } else if (command == "CancelFlight") {
-        if (args.size() >= 2) {
-            scheduler.cancelFlight(args[0], args[1], output);
-        }
-    } else if (command == "Reprioritize") {
-        if (args.size() >= 3) {
-            scheduler.reprioritize(args[0], args[1], args[2], output);
-        }
-    } else if (command == "AddRunways") {
-        if (args.size() >= 2) {
-            scheduler.addRunways(args[0], args[1], output);
-        }
-    } else if (command == "GroundHold") {
-        if (args.size() >= 3) {
-            scheduler.groundHold(args[0], args[1], args[2], output);
-        }
-    } else if (command == "PrintActive") {
-        scheduler.printActive(output);
-    } else if (command == "PrintSchedule") {
-        if (args.size() >= 2) {
-            scheduler.printSchedule(args[0], args[1], output);
-        }
-    } else if (command == "Tick") {
-        if (args.size() >= 1) {
-            scheduler.tick(args[0], output);
-        }
-    } else if (command == "Quit") {
-        output.push_back("Program Terminated!!");
-    }
+// Server stopped by SIGINT/SIGTERM in --serve mode
+static SchedulerServer* activeServer = nullptr;
+
+static void stopServer(int) {
+    if (activeServer) activeServer->requestStop();
 }
 
 // Main entry: read input, execute commands, write output
 int main(int argc, char* argv[]) {
-    if (argc != 2) {
-        std::cerr << "Usage: " << argv[0] << " <input_file>" << std::endl;
+    // --threads=N advances runway groups on N threads;
+    // --pipelined parses, schedules and writes on separate threads;
+    // --journal=PATH journals state changes, syncing every --commit-every
+    // commands and checkpointing every --checkpoint-every; --recover first
+    // rebuilds state from an existing journal; --serve=SOCKET takes
+    // commands from clients of a Unix domain socket instead of a file, with
+    // --readers=N threads answering queries from published views
+    LoopOptions options;
+    bool pipelined = false;
+    int threads = 1;
+    std::string journalPath;
+    std::string socketPath;
+    int readers = 0;
+    int commitEvery = 64;
+    int checkpointEvery = 100000;
+    bool recover = false;
+    bool badOption = false;
+    // The input file is the last argument unless serving
+    int optionEnd = argc - 1;
+    if (argc >= 2 && std::string(argv[argc - 1]).compare(0, 8, "--serve=") == 0) {
+        optionEnd = argc;
+    }
+    for (int i = 1; i < optionEnd; i++) {
+        std::string option = argv[i];
+        if (option == "--pipelined") {
+            pipelined = true;
+        } else if (option.compare(0, 10, "--threads=") == 0) {
+            threads = std::atoi(option.c_str() + 10);
+            badOption = badOption || threads < 1;
+        } else if (option.compare(0, 10, "--journal=") == 0) {
+            journalPath = option.substr(10);
+        } else if (option.compare(0, 15, "--commit-every=") == 0) {
+            commitEvery = std::atoi(option.c_str() + 15);
+            badOption = badOption || commitEvery < 1;
+        } else if (option.compare(0, 19, "--checkpoint-every=") == 0) {
+            checkpointEvery = std::atoi(option.c_str() + 19);
+            badOption = badOption || checkpointEvery < 0;
+        } else if (option == "--recover") {
+            recover = true;
+        } else if (option.compare(0, 8, "--serve=") == 0) {
+            socketPath = option.substr(8);
+            badOption = badOption || socketPath.empty();
+        } else if (option.compare(0, 10, "--readers=") == 0) {
+            readers = std::atoi(option.c_str() + 10);
+            badOption = badOption || readers < 0;
+        } else {
+            badOption = true;
+        }
+    }
+    bool serving = !socketPath.empty();
+    if (argc < 2 || badOption || (recover && journalPath.empty()) ||
+        (serving && optionEnd != argc)) {
+        std::cerr << "Usage: " << argv[0] << " [--threads=N] [--pipelined] "
+                  << "[--journal=PATH [--recover] [--commit-every=N] "
+                  << "[--checkpoint-every=N]] <input_file | [--readers=N] --serve=SOCKET>"
+                  << std::endl;
         return 1;
     }
     
-    std::string inputFilename = argv[1];
+    RunwayGroups scheduler(threads);
+    Journal journal;
+    if (!journalPath.empty()) {
+        bool opened = recover ? journal.recover(journalPath, commitEvery, scheduler)
+                              : journal.create(journalPath, commitEvery);
+        if (!opened) {
+            std::cerr << "Error " << (recover ? "recovering from" : "creating") 
+                      << " journal: " << journalPath << std::endl;
+            return 1;
+        }
+        options.journal = &journal;
+        options.checkpointEvery = checkpointEvery;
+    }
+    
+    if (serving) {
+        SchedulerServer server(scheduler, options, readers);
+        if (!server.listen(socketPath)) {
+            std::cerr << "Error listening on socket: " << socketPath << std::endl;
+            return 1;
+        }
+        activeServer = &server;
+        std::signal(SIGINT, stopServer);
+        std::signal(SIGTERM, stopServer);
+        server.run();
+        activeServer = nullptr;
+        if (options.journal) journal.commit();
+        return 0;
+    }
+    
+    std::string inputFilename = argv[argc - 1];
     std::string outputFilename = inputFilename;
     
     size_t dotPos = outputFilename.find_last_of('.');
@@ -82,42 +111,33 @@ int main(int argc, char* argv[]) {
     }
     outputFilename += "_output_file.txt";
     
-    std::ifstream inputFile(inputFilename);
-    if (!inputFile.is_open()) {
+    // The input is mapped and decoded in place
+    MappedFile inputFile;
+    if (!inputFile.open(inputFilename)) {
         std::cerr << "Error opening input file: " << inputFilename << std::endl;
         return 1;
     }
     
-    Scheduler scheduler;
-    std::vector<std::string> output;
-    std::string line;
-    
-    while (std::getline(inputFile, line)) {
-        line.erase(0, line.find_first_not_of(" \t\r\n"));
-        line.erase(line.find_last_not_of(" \t\r\n") + 1);
-        
-        if (line.empty()) continue;
-        
-        parseAndExecute(line, scheduler, output);
-        
-        if (line.find("Quit") != std::string::npos) {
-            break;
-        }
-    }
-    
-    inputFile.close();
-    
-    std::ofstream outputFile(outputFilename);
-    if (!outputFile.is_open()) {
+    // Output streams to the file as commands run
+    FileSink output(outputFilename);
+    if (!output.isOpen()) {
         std::cerr << "Error opening output file: " << outputFilename << std::endl;
         return 1;
     }
     
-    for (const auto& str : output) {
-        outputFile << str << std::endl;
+    if (pipelined) {
+        runPipelined(inputFile.begin(), inputFile.end(), scheduler, options, output);
+    } else {
+        runSequential(inputFile.begin(), inputFile.end(), scheduler, options, output);
     }
+    output.flush();
     
-    outputFile.close();
+#ifdef SCHEDULER_STATS
+    // Instrumented builds report to stderr on exit
+    StringSink stats;
+    scheduler.printStats(stats);
+    std::cerr << stats.str();
+#endif
     
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,65 @@
+// Runs a command file through RunwayGroups and, after every command,
+// publishes a view and checks that it answers PrintActive and
+// PrintSchedule exactly as the live groups do. Exits 1 at the first
+// difference.
+#include "RunwayGroups.h"
+#include <climits>
+#include <cstdio>
+#include <string>
+
+// Compare one query's answers; prints both on a mismatch
+static bool same(const char* input, int line, const char* query, StringSink& live,
+                 StringSink& view) {
+    if (live.str() == view.str()) return true;
+    std::fprintf(stderr, "%s:%d: %s differs\nlive:\n%sview:\n%s", input, line, query,
+                 live.str().c_str(), view.str().c_str());
+    return false;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        std::fprintf(stderr, "Usage: %s <input_file>\n", argv[0]);
+        return 1;
+    }
+    
+    MappedFile input;
+    if (!input.open(argv[1])) {
+        std::fprintf(stderr, "Error opening input file: %s\n", argv[1]);
+        return 1;
+    }
+    
+    RunwayGroups scheduler(1);
+    DiscardSink discard;
+    CommandReader reader(input.begin(), input.end());
+    Command command;
+    int line = 0;
+    
+    while (reader.next(command)) {
+        line++;
+        scheduler.execute(command, discard);
+        scheduler.publishView();
+        std::shared_ptr<const ScheduleView> view = scheduler.view();
+        
+        StringSink liveActive, viewActive;
+        scheduler.printActive(liveActive);
+        view->printActive(viewActive);
+        if (!same(argv[1], line, "PrintActive", liveActive, viewActive)) return 1;
+        
+        // The whole schedule, then narrow windows
+        for (int t = -5; t <= 100; t += 5) {
+            int t1 = t < 0 ? INT_MIN : t;
+            int t2 = t < 0 ? INT_MAX : t + 4;
+            StringSink liveSchedule, viewSchedule;
+            scheduler.printSchedule(t1, t2, liveSchedule);
+            view->printSchedule(t1, t2, viewSchedule);
+            if (!same(argv[1], line, "PrintSchedule", liveSchedule, viewSchedule)) return 1;
+        }
+        
+        if (command.stop) {
+            break;
+        }
+    }
+    
+    std::printf("%s: views match after all %d commands\n", argv[1], line);
+    return 0;
+}